@@ -0,0 +1,68 @@
+#ifndef KECCAK_BENCH_H
+#define KECCAK_BENCH_H
+
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace keccak::bench {
+
+/**
+ * @brief Read the time stamp counter, or the steady clock in nanoseconds on targets without one.
+ *
+ * The time stamp counter ticks at the nominal frequency, so turbo or throttling skews cycles from core cycles.
+ * @return The current tick.
+ */
+inline auto cycles() -> uint64_t {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * @brief Build a deterministic input message.
+ * @param length The length of the message.
+ * @return The message.
+ */
+inline auto message(size_t length) -> std::vector<uint8_t> {
+    std::vector<uint8_t> buffer(length);
+    for (size_t i = 0; i < buffer.size(); ++i) buffer[i] = static_cast<uint8_t>(i * 7 + 3);
+    return buffer;
+}
+
+/**
+ * @brief Run the benchmark loop and report cycles/byte, cycles/op, bytes/s and msgs/s.
+ * @tparam F The callable type.
+ * @param state The benchmark state.
+ * @param bytes The number of input bytes hashed by one call of the body.
+ * @param messages The number of messages hashed by one call of the body.
+ * @param body The operation to measure.
+ */
+template<typename F>
+void run(benchmark::State &state, size_t bytes, size_t messages, F &&body) {
+    const uint64_t start = bench::cycles();
+    for (auto _: state) body();
+    const auto elapsed = static_cast<double>(bench::cycles() - start);
+    const auto iterations = static_cast<double>(state.iterations());
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+    if (bytes > 0) state.counters["cycles/byte"] = elapsed / (iterations * static_cast<double>(bytes));
+    state.counters["cycles/op"] = elapsed / iterations;
+    state.counters["msgs/s"] = benchmark::Counter(iterations * static_cast<double>(messages),
+                                                  benchmark::Counter::kIsRate);
+}
+
+} // namespace keccak::bench
+
+#endif //KECCAK_BENCH_H
@@ -0,0 +1,121 @@
+#include <benchmark/benchmark.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <span>
+#include <vector>
+
+#include "bench.h"
+#include "hash_service.h"
+#include "kangaroo_twelve.h"
+#include "merkle_tree.h"
+#include "parallel_hash.h"
+#include "sha3.h"
+#include "sponge_pool.h"
+
+/// The number of messages hashed by one batch.
+static constexpr size_t BATCH = 1024;
+
+static void BM_HashMany(benchmark::State &state) {
+    const auto length = static_cast<size_t>(state.range(0));
+    const auto buffer = keccak::bench::message(length * BATCH);
+    std::vector<std::span<const uint8_t>> buffers;
+    for (size_t i = 0; i < BATCH; ++i) buffers.emplace_back(buffer.data() + i * length, length);
+    std::vector<keccak::SHA3<256>::digest_type> digests(BATCH);
+    keccak::bench::run(state, length * BATCH, BATCH, [&] {
+        keccak::SHA3<256>::hash_many(buffers, digests);
+        benchmark::DoNotOptimize(digests.data());
+    });
+}
+BENCHMARK(BM_HashMany)->Arg(32)->Arg(64)->Arg(256)->Arg(1024);
+
+static void BM_HashMany_Baseline(benchmark::State &state) {
+    const auto length = static_cast<size_t>(state.range(0));
+    const auto buffer = keccak::bench::message(length * BATCH);
+    std::vector<keccak::SHA3<256>::digest_type> digests(BATCH);
+    keccak::bench::run(state, length * BATCH, BATCH, [&] {
+        for (size_t i = 0; i < BATCH; ++i) {
+            digests[i] = keccak::SHA3<256>::hash_digest(buffer.data() + i * length, length);
+        }
+        benchmark::DoNotOptimize(digests.data());
+    });
+}
+BENCHMARK(BM_HashMany_Baseline)->Arg(32)->Arg(64)->Arg(256)->Arg(1024);
+
+/// One chunk of input for each of many live contexts, absorbed at once or queued and flushed together.
+static void BM_SpongePool(benchmark::State &state) {
+    const auto length = static_cast<size_t>(state.range(0));
+    const bool queued = state.range(1) != 0;
+    const auto buffer = keccak::bench::message(length * BATCH);
+    keccak::SpongePool<keccak::SHA3Sponge<256>> pool;
+    std::vector<keccak::SpongePool<keccak::SHA3Sponge<256>>::Handle> handles;
+    for (size_t i = 0; i < BATCH; ++i) handles.push_back(pool.acquire());
+    keccak::bench::run(state, length * BATCH, BATCH, [&] {
+        for (size_t i = 0; i < BATCH; ++i) {
+            const auto *chunk = buffer.data() + i * length;
+            if (queued) {
+                pool.enqueue(handles[i], std::as_bytes(std::span(chunk, length)));
+            } else {
+                pool.update(handles[i], chunk, length);
+            }
+        }
+        pool.flush();
+    });
+}
+BENCHMARK(BM_SpongePool)->ArgsProduct({{136, 4096}, {0, 1}})->ArgNames({"bytes", "queued"});
+
+/// Small messages submitted one by one, as request threads would, then awaited.
+static void BM_HashService(benchmark::State &state) {
+    const auto length = static_cast<size_t>(state.range(0));
+    const auto buffer = keccak::bench::message(length * BATCH);
+    keccak::ThreadPool pool;
+    keccak::HashService<keccak::SHA3Sponge<256>> service(pool);
+    std::vector<std::future<keccak::SHA3Sponge<256>::digest_type>> futures(BATCH);
+    keccak::bench::run(state, length * BATCH, BATCH, [&] {
+        for (size_t i = 0; i < BATCH; ++i) futures[i] = service.submit(buffer.data() + i * length, length);
+        for (auto &future: futures) benchmark::DoNotOptimize(future.get());
+    });
+}
+BENCHMARK(BM_HashService)->Arg(32)->Arg(256)->UseRealTime();
+
+static void BM_ParallelHash128(benchmark::State &state) {
+    const auto length = static_cast<size_t>(state.range(0));
+    const auto buffer = keccak::bench::message(length);
+    keccak::ThreadPool pool;
+    std::array<uint8_t, 32> out{};
+    keccak::bench::run(state, length, 1, [&] {
+        keccak::ParallelHash128 hash(8192, {}, pool);
+        hash.update(buffer.data(), length);
+        hash.finalize(out.data(), out.size());
+        benchmark::DoNotOptimize(out);
+    });
+}
+BENCHMARK(BM_ParallelHash128)->Arg(1 << 20)->Arg(1 << 26)->UseRealTime();
+
+static void BM_KangarooTwelve(benchmark::State &state) {
+    const auto length = static_cast<size_t>(state.range(0));
+    const auto buffer = keccak::bench::message(length);
+    std::array<uint8_t, 32> out{};
+    keccak::bench::run(state, length, 1, [&] {
+        keccak::KangarooTwelve::hash_buffer(buffer.data(), length, out.data(), out.size());
+        benchmark::DoNotOptimize(out);
+    });
+}
+BENCHMARK(BM_KangarooTwelve)->Arg(64)->Arg(8192)->Arg(1 << 20)->Arg(1 << 26);
+
+static void BM_MerkleTree(benchmark::State &state) {
+    const auto count = static_cast<size_t>(state.range(0));
+    const auto workers = static_cast<size_t>(state.range(1));
+    const auto buffer = keccak::bench::message(count * sizeof(keccak::MerkleTree::Node));
+    std::vector<keccak::MerkleTree::Node> leaves(count);
+    std::memcpy(leaves.data(), buffer.data(), buffer.size());
+    keccak::ThreadPool pool(workers);
+    // Every internal node hashes 64 bytes.
+    keccak::bench::run(state, (count - 1) * 64, count - 1, [&] {
+        auto tree = workers > 0 ? keccak::MerkleTree(leaves, pool) : keccak::MerkleTree(leaves);
+        benchmark::DoNotOptimize(tree.root());
+    });
+}
+BENCHMARK(BM_MerkleTree)->ArgsProduct({{1 << 10, 1 << 20}, {0, 4}})->ArgNames({"leaves", "workers"})->UseRealTime();
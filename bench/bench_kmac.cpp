@@ -0,0 +1,34 @@
+#include <benchmark/benchmark.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "bench.h"
+#include "kmac.h"
+
+static constexpr std::array<uint8_t, 32> KEY{};
+
+static void BM_KMAC256_Fresh(benchmark::State &state) {
+    const auto length = static_cast<size_t>(state.range(0));
+    const auto buffer = keccak::bench::message(length);
+    std::array<uint8_t, 32> out{};
+    keccak::bench::run(state, length, 1, [&] {
+        keccak::KMAC256::hash_buffer(KEY.data(), KEY.size(), buffer.data(), length, out.data(), out.size());
+        benchmark::DoNotOptimize(out);
+    });
+}
+BENCHMARK(BM_KMAC256_Fresh)->Arg(16)->Arg(64)->Arg(256);
+
+static void BM_KMAC256_Midstate(benchmark::State &state) {
+    const auto length = static_cast<size_t>(state.range(0));
+    const auto buffer = keccak::bench::message(length);
+    const keccak::KMAC256 keyed(KEY.data(), KEY.size());
+    std::array<uint8_t, 32> out{};
+    keccak::bench::run(state, length, 1, [&] {
+        keccak::KMAC256 kmac = keyed;
+        kmac.update(buffer.data(), length);
+        kmac.finalize(out.data(), out.size());
+        benchmark::DoNotOptimize(out);
+    });
+}
+BENCHMARK(BM_KMAC256_Midstate)->Arg(16)->Arg(64)->Arg(256);
@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+#include <array>
+#include <cstdint>
+
+#include "bench.h"
+#include "dispatch.h"
+#include "keccak.h"
+#include "keccak_interleaved.h"
+#include "multi_buffer.h"
+
+using keccak::core::Kernel;
+
+static void BM_KeccakP(benchmark::State &state) {
+    std::array<uint64_t, keccak::core::P_LEN> lanes{};
+    keccak::bench::run(state, sizeof(lanes), 1, [&] {
+        keccak::core::permute(lanes);
+        benchmark::DoNotOptimize(lanes);
+    });
+    state.SetLabel(keccak::core::kernels().name);
+}
+BENCHMARK(BM_KeccakP);
+
+static void BM_KeccakP_Reference(benchmark::State &state) {
+    std::array<uint64_t, keccak::core::P_LEN> lanes{};
+    keccak::bench::run(state, sizeof(lanes), 1, [&] {
+        keccak::core::keccak_p_reference(lanes);
+        benchmark::DoNotOptimize(lanes);
+    });
+}
+BENCHMARK(BM_KeccakP_Reference);
+
+static void BM_KeccakP_Kernel(benchmark::State &state) {
+    const auto *kernels = keccak::core::kernels_for(static_cast<Kernel>(state.range(0)));
+    if (kernels == nullptr) {
+        state.SkipWithError("kernel not supported on this cpu");
+        return;
+    }
+    std::array<uint64_t, keccak::core::P_LEN> lanes{};
+    keccak::bench::run(state, sizeof(lanes), 1, [&] {
+        kernels->permute(lanes);
+        benchmark::DoNotOptimize(lanes);
+    });
+    state.SetLabel(kernels->name);
+}
+BENCHMARK(BM_KeccakP_Kernel)->DenseRange(static_cast<int>(Kernel::SCALAR), static_cast<int>(Kernel::INTERLEAVED));
+
+/// The bit-interleaved rounds alone, without converting the state; compare with BM_KeccakP in a -m32 build.
+static void BM_KeccakP_Interleaved(benchmark::State &state) {
+    keccak::core::interleaved_state lanes{};
+    keccak::bench::run(state, sizeof(lanes), 1, [&] {
+        keccak::core::keccak_p_interleaved(lanes);
+        benchmark::DoNotOptimize(lanes);
+    });
+}
+BENCHMARK(BM_KeccakP_Interleaved);
+
+static void BM_KeccakP_Many(benchmark::State &state) {
+    const size_t lanes = keccak::core::multi_buffer_lanes();
+    std::array<uint64_t, keccak::core::P_LEN * keccak::core::MAX_LANES> states{};
+    keccak::bench::run(state, lanes * keccak::core::P_LEN * sizeof(uint64_t), lanes, [&] {
+        keccak::core::keccak_p_many(states.data(), lanes);
+        benchmark::DoNotOptimize(states);
+    });
+    state.SetLabel(keccak::core::kernels().name);
+}
+BENCHMARK(BM_KeccakP_Many);
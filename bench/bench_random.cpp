@@ -0,0 +1,42 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "bench.h"
+#include "duplex_random.h"
+#include "sha3_256.h"
+
+static void BM_DuplexRandom_Fill(benchmark::State &state) {
+    const auto length = static_cast<size_t>(state.range(0));
+    std::vector<std::byte> out(length);
+    keccak::DuplexRandom128 random(1);
+    keccak::bench::run(state, length, 1, [&] {
+        random.fill(out);
+        benchmark::DoNotOptimize(out.data());
+    });
+}
+BENCHMARK(BM_DuplexRandom_Fill)->Arg(64)->Arg(4096)->Arg(1 << 20);
+
+static void BM_DuplexRandom_Word(benchmark::State &state) {
+    keccak::DuplexRandom128 random(1);
+    keccak::bench::run(state, sizeof(uint64_t), 1, [&] { benchmark::DoNotOptimize(random()); });
+}
+BENCHMARK(BM_DuplexRandom_Word);
+
+// The counter-hashing generator it replaces: one permutation per 32 bytes.
+static void BM_HashCounter_Fill(benchmark::State &state) {
+    const auto length = static_cast<size_t>(state.range(0));
+    std::vector<std::byte> out(length);
+    uint64_t counter = 0;
+    keccak::bench::run(state, length, 1, [&] {
+        for (size_t offset = 0; offset < length; offset += 32, ++counter) {
+            const auto digest = keccak::SHA3_256::hash_digest(&counter, sizeof(counter));
+            std::memcpy(out.data() + offset, digest.data(), std::min<size_t>(32, length - offset));
+        }
+        benchmark::DoNotOptimize(out.data());
+    });
+}
+BENCHMARK(BM_HashCounter_Fill)->Arg(4096)->Arg(1 << 20);
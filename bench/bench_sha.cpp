@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "bench.h"
+#include "multi_digest.h"
+#include "sha3.h"
+#include "sponge.h"
+
+/// The largest buffer fed to update at once; longer messages reuse it.
+static constexpr size_t CHUNK = 1 << 20;
+
+template<size_t BIT>
+static void BM_Update(benchmark::State &state) {
+    const auto length = static_cast<size_t>(state.range(0));
+    const auto flag = static_cast<uint8_t>(state.range(1));
+    const auto buffer = keccak::bench::message(std::min(length, CHUNK));
+    keccak::bench::run(state, length, 1, [&] {
+        keccak::SHA3<BIT> sha3(flag);
+        for (size_t offset = 0; offset < length; offset += buffer.size()) {
+            sha3.update(buffer.data(), std::min(buffer.size(), length - offset));
+        }
+        benchmark::DoNotOptimize(sha3.digest());
+    });
+    state.SetLabel(flag == 1 ? "keccak" : "sha3");
+}
+BENCHMARK(BM_Update<256>)->ArgsProduct({benchmark::CreateRange(1, 1 << 30, 16), {0, 1}})->ArgNames({"bytes", "keccak"});
+BENCHMARK(BM_Update<384>)->ArgsProduct({benchmark::CreateRange(1, 1 << 30, 16), {0, 1}})->ArgNames({"bytes", "keccak"});
+BENCHMARK(BM_Update<512>)->ArgsProduct({benchmark::CreateRange(1, 1 << 30, 16), {0, 1}})->ArgNames({"bytes", "keccak"});
+
+template<size_t BIT>
+static void BM_HashBuffer(benchmark::State &state) {
+    const auto length = static_cast<size_t>(state.range(0));
+    const auto buffer = keccak::bench::message(length);
+    keccak::bench::run(state, length, 1, [&] {
+        benchmark::DoNotOptimize(keccak::SHA3<BIT>::hash_buffer(buffer.data(), length, 0));
+    });
+}
+BENCHMARK(BM_HashBuffer<256>)->Arg(0)->Arg(32)->Arg(64)->Arg(135)->Arg(136);
+BENCHMARK(BM_HashBuffer<512>)->Arg(0)->Arg(32)->Arg(64)->Arg(71)->Arg(72);
+
+template<typename SPONGE>
+static void BM_HashDigest(benchmark::State &state) {
+    const auto length = static_cast<size_t>(state.range(0));
+    const auto buffer = keccak::bench::message(length);
+    keccak::bench::run(state, length, 1, [&] {
+        benchmark::DoNotOptimize(SPONGE::hash_digest(buffer.data(), length));
+    });
+}
+BENCHMARK(BM_HashDigest<keccak::SHA3Sponge<256>>)->Arg(32)->Arg(64);
+BENCHMARK(BM_HashDigest<keccak::Keccak256>)->Arg(32)->Arg(64);
+
+template<typename SPONGE, size_t N>
+static void BM_HashFixed(benchmark::State &state) {
+    const auto buffer = keccak::bench::message(N);
+    keccak::bench::run(state, N, 1, [&] {
+        benchmark::DoNotOptimize(SPONGE::template hash_fixed<N>(buffer.data()));
+    });
+}
+BENCHMARK(BM_HashFixed<keccak::SHA3Sponge<256>, 32>);
+BENCHMARK(BM_HashFixed<keccak::SHA3Sponge<256>, 64>);
+BENCHMARK(BM_HashFixed<keccak::Keccak256, 32>);
+BENCHMARK(BM_HashFixed<keccak::Keccak256, 64>);
+
+static void BM_MultiDigest(benchmark::State &state) {
+    const auto length = static_cast<size_t>(state.range(0));
+    const auto buffer = keccak::bench::message(length);
+    keccak::bench::run(state, length, 1, [&] {
+        benchmark::DoNotOptimize(keccak::MultiDigest<keccak::SHA3Sponge<256>, keccak::Keccak256,
+                keccak::SHA3Sponge<512>>::hash_buffer(buffer.data(), length));
+    });
+}
+BENCHMARK(BM_MultiDigest)->Arg(1 << 12)->Arg(1 << 26);
+
+// The same three hashes as separate passes.
+static void BM_MultiDigest_Baseline(benchmark::State &state) {
+    const auto length = static_cast<size_t>(state.range(0));
+    const auto buffer = keccak::bench::message(length);
+    keccak::bench::run(state, length, 1, [&] {
+        benchmark::DoNotOptimize(keccak::SHA3Sponge<256>::hash_digest(buffer.data(), length));
+        benchmark::DoNotOptimize(keccak::Keccak256::hash_digest(buffer.data(), length));
+        benchmark::DoNotOptimize(keccak::SHA3Sponge<512>::hash_digest(buffer.data(), length));
+    });
+}
+BENCHMARK(BM_MultiDigest_Baseline)->Arg(1 << 12)->Arg(1 << 26);
@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+"""Flag throughput regressions between two Keccak_BENCH JSON reports.
+
+Produce a report with:
+
+    Keccak_BENCH --benchmark_out=current.json --benchmark_out_format=json
+
+then compare it against a stored baseline:
+
+    bench/compare.py baseline.json current.json --threshold 0.05
+
+Benchmarks are matched by name and compared on cycles/byte, or cycles/op and then real time when a benchmark has
+no input bytes. The script exits with status 1 if any benchmark got slower by more than the threshold.
+"""
+
+import argparse
+import json
+import sys
+
+METRICS = ("cycles/byte", "cycles/op", "real_time")
+
+
+def load(path):
+    with open(path) as report:
+        benchmarks = json.load(report)["benchmarks"]
+    # With repetitions, compare the medians instead of the individual runs.
+    medians = {b["run_name"]: b for b in benchmarks if b.get("aggregate_name") == "median"}
+    runs = {b["name"]: b for b in benchmarks if b.get("run_type", "iteration") == "iteration" and "error_occurred" not in b}
+    return {**runs, **medians}
+
+
+def metric(benchmark):
+    for name in METRICS:
+        if name in benchmark:
+            return name, float(benchmark[name])
+    return None, None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline", help="the stored baseline report")
+    parser.add_argument("current", help="the report to check")
+    parser.add_argument("--threshold", type=float, default=0.05, help="the tolerated slowdown, 0.05 for 5%%")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    regressions = 0
+    for name, benchmark in current.items():
+        if name not in baseline:
+            print(f"{'NEW':>10}  {name}")
+            continue
+        unit, value = metric(benchmark)
+        _, reference = metric(baseline[name])
+        if unit is None or reference is None or reference == 0:
+            continue
+        change = value / reference - 1
+        regressed = change > args.threshold
+        regressions += regressed
+        print(f"{'REGRESSED' if regressed else 'ok':>10}  {name}  {unit} {reference:.4g} -> {value:.4g} ({change:+.1%})")
+
+    for name in baseline.keys() - current.keys():
+        print(f"{'MISSING':>10}  {name}")
+
+    print(f"{regressions} regression(s) above {args.threshold:.0%}")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
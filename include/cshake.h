@@ -0,0 +1,113 @@
+#ifndef KECCAK_CSHAKE_H
+#define KECCAK_CSHAKE_H
+
+#include <cstdint>
+#include <string_view>
+
+#include "shake.h"
+
+namespace keccak {
+
+/**
+ * @brief The NIST SP 800-185 string encodings, absorbed straight into a sponge.
+ */
+namespace core {
+
+/**
+ * @brief Absorb `left_encode(x)`.
+ * @param sponge The sponge.
+ * @param x The integer to encode.
+ * @return The number of bytes absorbed.
+ */
+template<typename Sponge>
+constexpr size_t left_encode(Sponge &sponge, uint64_t x) {
+    uint8_t bytes[9]{};
+    size_t n = 1;
+    while (n < 8 && (x >> (8 * n)) != 0) ++n;
+    bytes[0] = static_cast<uint8_t>(n);
+    for (size_t i = 0; i < n; ++i) bytes[1 + i] = static_cast<uint8_t>(x >> (8 * (n - 1 - i)));
+    sponge.update(bytes, n + 1);
+    return n + 1;
+}
+
+/**
+ * @brief Absorb `right_encode(x)`.
+ * @param sponge The sponge.
+ * @param x The integer to encode.
+ * @return The number of bytes absorbed.
+ */
+template<typename Sponge>
+constexpr size_t right_encode(Sponge &sponge, uint64_t x) {
+    uint8_t bytes[9]{};
+    size_t n = 1;
+    while (n < 8 && (x >> (8 * n)) != 0) ++n;
+    for (size_t i = 0; i < n; ++i) bytes[i] = static_cast<uint8_t>(x >> (8 * (n - 1 - i)));
+    bytes[n] = static_cast<uint8_t>(n);
+    sponge.update(bytes, n + 1);
+    return n + 1;
+}
+
+/**
+ * @brief Absorb `encode_string(s)`.
+ * @param sponge The sponge.
+ * @param s The string.
+ * @param length The length of the string in bytes.
+ * @return The number of bytes absorbed.
+ */
+template<typename Sponge>
+constexpr size_t encode_string(Sponge &sponge, const void *s, size_t length) {
+    const size_t n = left_encode(sponge, static_cast<uint64_t>(length) * 8);
+    sponge.update(s, length);
+    return n + length;
+}
+
+/**
+ * @brief Absorb the zeros that complete `bytepad(..., w)`.
+ * @param sponge The sponge.
+ * @param absorbed The number of bytes absorbed since the `left_encode(w)` that opened the bytepad.
+ * @param w The width.
+ */
+template<typename Sponge>
+constexpr void bytepad_zeros(Sponge &sponge, size_t absorbed, size_t w) {
+    constexpr uint8_t zeros[64]{};
+    for (size_t n = (w - absorbed % w) % w; n > 0;) {
+        const size_t chunk = n < sizeof(zeros) ? n : sizeof(zeros);
+        sponge.update(zeros, chunk);
+        n -= chunk;
+    }
+}
+
+} // namespace core
+
+/**
+ * @brief The cSHAKE customizable extendable-output function (NIST SP 800-185).
+ * @tparam BIT The security strength, 128 or 256.
+ */
+template<size_t BIT>
+class CSHAKE : public SHAKE<BIT> {
+public:
+    /**
+     * @brief Initialize a cSHAKE instance; with an empty name and customization it is plain SHAKE.
+     * @param name The function name N, reserved for NIST-defined functions.
+     * @param customization The customization string S.
+     */
+    constexpr explicit CSHAKE(std::string_view name = {}, std::string_view customization = {});
+};
+
+using CSHAKE128 = CSHAKE<128>;
+using CSHAKE256 = CSHAKE<256>;
+
+template<size_t BIT>
+constexpr CSHAKE<BIT>::CSHAKE(std::string_view name, std::string_view customization)
+        : SHAKE<BIT>(name.empty() && customization.empty() ? 0x1f : 0x04) {
+    if (name.empty() && customization.empty()) return;
+
+    size_t absorbed = core::left_encode(*this, SHAKE<BIT>::RATE);
+    absorbed += core::encode_string(*this, name.data(), name.size());
+    absorbed += core::encode_string(*this, customization.data(), customization.size());
+    core::bytepad_zeros(*this, absorbed, SHAKE<BIT>::RATE);
+}
+
+} // namespace keccak
+
+#endif //KECCAK_CSHAKE_H
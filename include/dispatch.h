@@ -0,0 +1,123 @@
+#ifndef KECCAK_DISPATCH_H
+#define KECCAK_DISPATCH_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "instrumentation.h"
+#include "keccak.h"
+
+/**
+ * @brief The runtime selection of the permutation kernels.
+ *
+ * The best kernel set for the running CPU is picked once, on first use. Setting the `KECCAK_KERNEL` environment
+ * variable to `scalar`, `bmi2`, `avx2`, `avx512` or `interleaved` forces a variant, as long as the CPU supports it.
+ */
+namespace keccak::core {
+
+/// The kernel variants: the scalar and x86-64 ones from the most portable to the widest, then the 32-bit one.
+enum class Kernel : uint8_t {
+    SCALAR,
+    BMI2,
+    AVX2,
+    AVX512,
+    /// The bit-interleaved permutation for 32-bit targets, only picked when forced.
+    INTERLEAVED,
+};
+
+/**
+ * @brief A set of permutation kernels built for one instruction set.
+ */
+struct Kernels {
+    /// The variant.
+    Kernel kernel;
+    /// The name of the variant, as accepted by `KECCAK_KERNEL`.
+    const char *name;
+    /// The number of states `permute_many` runs at once, 1 if the variant has no multi-buffer permutation.
+    size_t lanes;
+    /// The single-state permutation.
+    void (*permute)(std::array<uint64_t, P_LEN> &state);
+    /// The multi-buffer permutation on `lanes` interleaved states, null if `lanes` is 1.
+    void (*permute_many)(uint64_t *states);
+    /// XOR `blocks` consecutive blocks of `rate_words` little-endian words into the state, permuting after each.
+    void (*absorb)(std::array<uint64_t, P_LEN> &state, const uint8_t *data, size_t blocks, size_t rate_words);
+    /// `permute` with the 12 rounds of KangarooTwelve and TurboSHAKE.
+    void (*permute_12)(std::array<uint64_t, P_LEN> &state);
+    /// `permute_many` with 12 rounds.
+    void (*permute_many_12)(uint64_t *states);
+    /// `absorb` with 12 rounds.
+    void (*absorb_12)(std::array<uint64_t, P_LEN> &state, const uint8_t *data, size_t blocks, size_t rate_words);
+};
+
+/**
+ * @brief The kernel set selected for this process.
+ * @return The kernel set.
+ */
+auto kernels() -> const Kernels &;
+
+/**
+ * @brief Look up the kernel set of a variant.
+ * @param kernel The variant.
+ * @return The kernel set, or null if the variant is not built or not supported by the CPU.
+ */
+auto kernels_for(Kernel kernel) -> const Kernels *;
+
+/**
+ * @brief Apply the keccak permutation with the selected kernel, or the portable one in constant evaluation.
+ * @tparam N_R The number of rounds, 24 or 12.
+ * @param state The state to operate on.
+ */
+template<size_t N_R = ROUNDS>
+constexpr inline void permute(std::array<uint64_t, P_LEN> &state) {
+    static_assert(N_R == ROUNDS || N_R == 12);
+    instrumentation::count_permutations(1);
+#ifdef KECCAK_REFERENCE_PERMUTATION
+    keccak_p<N_R>(state);
+#else
+    if (std::is_constant_evaluated()) {
+        keccak_p<N_R>(state);
+    } else if constexpr (N_R == ROUNDS) {
+        kernels().permute(state);
+    } else {
+        kernels().permute_12(state);
+    }
+#endif
+}
+
+/**
+ * @brief Absorb whole rate-sized blocks with the selected kernel, or the portable loop in constant evaluation.
+ * @tparam N_R The number of rounds, 24 or 12.
+ * @tparam Byte The byte type of the blocks.
+ * @param state The state to operate on, at the start of a block.
+ * @param data The blocks.
+ * @param blocks The number of blocks.
+ * @param rate_words The rate in words.
+ */
+template<size_t N_R = ROUNDS, typename Byte>
+constexpr inline void absorb(std::array<uint64_t, P_LEN> &state, const Byte *data, size_t blocks, size_t rate_words) {
+    static_assert(N_R == ROUNDS || N_R == 12);
+    instrumentation::count_permutations(blocks);
+#ifdef KECCAK_REFERENCE_PERMUTATION
+    for (; blocks > 0; --blocks) {
+        for (size_t i = 0; i < rate_words; ++i, data += sizeof(uint64_t)) state[i] ^= load_le64(data);
+        keccak_p<N_R>(state);
+    }
+#else
+    if (std::is_constant_evaluated()) {
+        for (; blocks > 0; --blocks) {
+            for (size_t i = 0; i < rate_words; ++i, data += sizeof(uint64_t)) state[i] ^= load_le64(data);
+            keccak_p<N_R>(state);
+        }
+    } else if constexpr (N_R == ROUNDS) {
+        kernels().absorb(state, reinterpret_cast<const uint8_t *>(data), blocks, rate_words);
+    } else {
+        kernels().absorb_12(state, reinterpret_cast<const uint8_t *>(data), blocks, rate_words);
+    }
+#endif
+}
+
+} // namespace keccak::core
+
+#endif //KECCAK_DISPATCH_H
@@ -0,0 +1,171 @@
+#ifndef KECCAK_DUPLEX_RANDOM_H
+#define KECCAK_DUPLEX_RANDOM_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+#include "dispatch.h"
+#include "keccak.h"
+
+namespace keccak {
+
+/**
+ * @brief A deterministic random bit generator on the keccak duplex construction.
+ *
+ * Seeding absorbs the seed like SHAKE does, and the output is squeezed a full rate per permutation, so a freshly
+ * seeded generator streams exactly SHAKE of its seed. Reseeding and forking duplex more input into the running
+ * state. It satisfies UniformRandomBitGenerator, and is a plain value that can be copied to replay a stream.
+ * @tparam BIT The security strength, 128 or 256.
+ */
+template<size_t BIT = 128>
+class DuplexRandom {
+public:
+    using result_type = uint64_t;
+    /// The rate in bytes, the output of one permutation.
+    static constexpr size_t RATE = 200 - BIT / 4;
+
+private:
+    /// The domain byte of seeds, that of SHAKE.
+    static constexpr uint8_t SEED_DOMAIN = 0x1f;
+    /// The domain byte of fork labels.
+    static constexpr uint8_t FORK_DOMAIN = 0x0d;
+
+    /// The state; its rate is the current output block.
+    std::array<uint64_t, core::P_LEN> state;
+    /// The next byte of the current output block.
+    size_t offset;
+
+public:
+    /**
+     * @brief Seed a generator with an integer, absorbed as 8 little-endian bytes.
+     * @param seed The seed.
+     */
+    explicit DuplexRandom(uint64_t seed = 0);
+
+    /**
+     * @brief Seed a generator with a byte string.
+     * @param seed The seed.
+     */
+    explicit DuplexRandom(std::span<const std::byte> seed);
+
+    static constexpr auto min() -> result_type { return 0; }
+
+    static constexpr auto max() -> result_type { return std::numeric_limits<result_type>::max(); }
+
+    /**
+     * @brief Draw the next 8 bytes of the stream as a little-endian word, skipping to a word boundary first.
+     * @return The word.
+     */
+    auto operator()() -> result_type;
+
+    /**
+     * @brief Write the next bytes of the stream straight into a buffer.
+     * @param out The buffer.
+     */
+    void fill(std::span<std::byte> out);
+
+    /**
+     * @brief Mix more seed material into the state; the stream continues from a new output block.
+     * @param seed The seed material.
+     */
+    void reseed(std::span<const std::byte> seed);
+
+    /**
+     * @brief Derive an independent substream, leaving this generator untouched.
+     *
+     * The same label forked from the same state gives the same substream; different labels give unrelated ones.
+     * @param stream The label of the substream.
+     * @return The generator of the substream.
+     */
+    [[nodiscard]] auto fork(uint64_t stream) const -> DuplexRandom;
+
+private:
+    void duplex(const uint8_t *data, size_t length, uint8_t domain);
+};
+
+using DuplexRandom128 = DuplexRandom<128>;
+using DuplexRandom256 = DuplexRandom<256>;
+
+template<size_t BIT>
+DuplexRandom<BIT>::DuplexRandom(uint64_t seed) : state{}, offset{0} {
+    static_assert(BIT == 128 || BIT == 256);
+    uint8_t bytes[sizeof(seed)];
+    core::store_le64(bytes, seed);
+    this->duplex(bytes, sizeof(bytes), DuplexRandom::SEED_DOMAIN);
+}
+
+template<size_t BIT>
+DuplexRandom<BIT>::DuplexRandom(std::span<const std::byte> seed) : state{}, offset{0} {
+    static_assert(BIT == 128 || BIT == 256);
+    this->duplex(reinterpret_cast<const uint8_t *>(seed.data()), seed.size(), DuplexRandom::SEED_DOMAIN);
+}
+
+template<size_t BIT>
+auto DuplexRandom<BIT>::operator()() -> result_type {
+    this->offset = (this->offset + 7) & ~static_cast<size_t>(7);
+    if (this->offset == DuplexRandom::RATE) {
+        core::permute(this->state);
+        this->offset = 0;
+    }
+    const uint64_t x = this->state[this->offset / 8];
+    this->offset += sizeof(x);
+    return x;
+}
+
+template<size_t BIT>
+void DuplexRandom<BIT>::fill(std::span<std::byte> out) {
+    auto *buffer = reinterpret_cast<uint8_t *>(out.data());
+    size_t length = out.size();
+    while (length > 0) {
+        if (this->offset == DuplexRandom::RATE) {
+            core::permute(this->state);
+            this->offset = 0;
+        }
+        const size_t n = std::min(length, DuplexRandom::RATE - this->offset);
+        core::store_bytes(this->state, this->offset, buffer, n);
+        this->offset += n;
+        buffer += n;
+        length -= n;
+    }
+}
+
+template<size_t BIT>
+void DuplexRandom<BIT>::reseed(std::span<const std::byte> seed) {
+    this->duplex(reinterpret_cast<const uint8_t *>(seed.data()), seed.size(), DuplexRandom::SEED_DOMAIN);
+}
+
+template<size_t BIT>
+auto DuplexRandom<BIT>::fork(uint64_t stream) const -> DuplexRandom {
+    DuplexRandom child = *this;
+    uint8_t bytes[sizeof(stream)];
+    core::store_le64(bytes, stream);
+    child.duplex(bytes, sizeof(bytes), DuplexRandom::FORK_DOMAIN);
+    return child;
+}
+
+template<size_t BIT>
+void DuplexRandom<BIT>::duplex(const uint8_t *data, size_t length, uint8_t domain) {
+    constexpr size_t RATE_WORDS = DuplexRandom::RATE / sizeof(uint64_t);
+
+    // The input goes over the rate from its start like a fresh SHAKE message; the unread output is dropped.
+    for (; length >= DuplexRandom::RATE; data += DuplexRandom::RATE, length -= DuplexRandom::RATE) {
+        for (size_t i = 0; i < RATE_WORDS; ++i) this->state[i] ^= core::load_le64(data + i * sizeof(uint64_t));
+        core::permute(this->state);
+    }
+
+    std::array<uint8_t, DuplexRandom::RATE> last{};
+    std::copy_n(data, length, last.begin());
+    last[length] ^= domain;
+    last[DuplexRandom::RATE - 1] ^= 0x80;
+    for (size_t i = 0; i < RATE_WORDS; ++i) this->state[i] ^= core::load_le64(last.data() + i * sizeof(uint64_t));
+    core::permute(this->state);
+    this->offset = 0;
+}
+
+} // namespace keccak
+
+#endif //KECCAK_DUPLEX_RANDOM_H
@@ -0,0 +1,173 @@
+#ifndef KECCAK_HASH_SERVICE_H
+#define KECCAK_HASH_SERVICE_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <iterator>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "multi_buffer.h"
+#include "sponge.h"
+#include "thread_pool.h"
+
+namespace keccak {
+
+/**
+ * @brief An asynchronous hasher coalescing small messages from many threads into multi-buffer batches.
+ *
+ * A dispatcher thread hands a batch to the worker pool as soon as it is full, or once its oldest message has waited
+ * for the deadline, so a lone message is never delayed by more than the deadline. The workers hash a batch with
+ * `hash_many`, which runs its messages in the lanes of the multi-buffer permutation, and fulfil the futures.
+ * @tparam SPONGE The sponge, e.g. `SHA3Sponge<256>` or `Keccak256`.
+ */
+template<typename SPONGE = SHA3Sponge<256>>
+class HashService {
+public:
+    using digest_type = typename SPONGE::digest_type;
+    using clock = std::chrono::steady_clock;
+
+private:
+    struct Request {
+        std::vector<uint8_t> message;
+        std::promise<digest_type> promise;
+        clock::time_point arrival;
+    };
+
+    ThreadPool &pool;
+    /// The longest a message waits for its batch to fill.
+    const clock::duration deadline;
+    /// The number of messages of a full batch.
+    const size_t batch;
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    /// The messages waiting for a batch, oldest first.
+    std::vector<Request> pending;
+    bool stopping;
+    std::thread dispatcher;
+
+public:
+    /**
+     * @brief Start the dispatcher.
+     * @param pool The workers hashing the batches; it must outlive the service.
+     * @param deadline The longest a message waits for its batch to fill.
+     * @param batch The number of messages of a full batch, 0 for eight rounds of multi-buffer lanes.
+     */
+    explicit HashService(ThreadPool &pool, std::chrono::microseconds deadline = std::chrono::microseconds(200),
+                         size_t batch = 0);
+
+    /**
+     * @brief Dispatch the waiting messages and stop the dispatcher; the batches in flight still complete.
+     */
+    ~HashService();
+
+    HashService(const HashService &) = delete;
+    HashService &operator=(const HashService &) = delete;
+
+    /**
+     * @brief Queue a message, copying it.
+     * @param buf_in The input message.
+     * @param length The length of the input message.
+     * @return The future hash.
+     */
+    auto submit(const void *buf_in, size_t length) -> std::future<digest_type>;
+
+    /**
+     * @brief Queue a message.
+     * @param message The input message.
+     * @return The future hash.
+     */
+    auto submit(std::vector<uint8_t> message) -> std::future<digest_type>;
+
+private:
+    void run();
+
+    /**
+     * @brief Hash a batch and fulfil its futures.
+     * @param requests The batch.
+     */
+    static void complete(std::vector<Request> requests);
+};
+
+template<typename SPONGE>
+HashService<SPONGE>::HashService(ThreadPool &pool, std::chrono::microseconds deadline, size_t batch)
+        : pool{pool}, deadline{deadline}, batch{batch > 0 ? batch : core::multi_buffer_lanes() * 8}, stopping{false} {
+    this->dispatcher = std::thread([this] { this->run(); });
+}
+
+template<typename SPONGE>
+HashService<SPONGE>::~HashService() {
+    {
+        std::lock_guard lock(this->mutex);
+        this->stopping = true;
+    }
+    this->ready.notify_one();
+    this->dispatcher.join();
+}
+
+template<typename SPONGE>
+auto HashService<SPONGE>::submit(const void *buf_in, size_t length) -> std::future<digest_type> {
+    const auto *bytes = static_cast<const uint8_t *>(buf_in);
+    return this->submit(std::vector<uint8_t>(bytes, bytes + length));
+}
+
+template<typename SPONGE>
+auto HashService<SPONGE>::submit(std::vector<uint8_t> message) -> std::future<digest_type> {
+    std::promise<digest_type> promise;
+    auto future = promise.get_future();
+    size_t waiting;
+    {
+        std::lock_guard lock(this->mutex);
+        this->pending.push_back({std::move(message), std::move(promise), clock::now()});
+        waiting = this->pending.size();
+    }
+    // The first message arms the deadline, and a full batch goes at once.
+    if (waiting == 1 || waiting == this->batch) this->ready.notify_one();
+    return future;
+}
+
+template<typename SPONGE>
+void HashService<SPONGE>::run() {
+    std::unique_lock lock(this->mutex);
+    for (;;) {
+        if (this->pending.empty()) {
+            if (this->stopping) return;
+            this->ready.wait(lock, [this] { return this->stopping || !this->pending.empty(); });
+            continue;
+        }
+
+        const auto due = this->pending.front().arrival + this->deadline;
+        this->ready.wait_until(lock, due, [this] { return this->stopping || this->pending.size() >= this->batch; });
+
+        const size_t n = std::min(this->pending.size(), this->batch);
+        std::vector<Request> requests(std::make_move_iterator(this->pending.begin()),
+                                      std::make_move_iterator(this->pending.begin() + n));
+        this->pending.erase(this->pending.begin(), this->pending.begin() + n);
+
+        lock.unlock();
+        this->pool.submit([requests = std::move(requests)]() mutable { HashService::complete(std::move(requests)); });
+        lock.lock();
+    }
+}
+
+template<typename SPONGE>
+void HashService<SPONGE>::complete(std::vector<Request> requests) {
+    std::vector<std::span<const uint8_t>> buffers;
+    buffers.reserve(requests.size());
+    for (const auto &request: requests) buffers.emplace_back(request.message);
+
+    std::vector<digest_type> digests(requests.size());
+    SPONGE::hash_many(buffers, digests);
+    for (size_t i = 0; i < requests.size(); ++i) requests[i].promise.set_value(digests[i]);
+}
+
+} // namespace keccak
+
+#endif //KECCAK_HASH_SERVICE_H
@@ -0,0 +1,141 @@
+#ifndef KECCAK_INSTRUMENTATION_H
+#define KECCAK_INSTRUMENTATION_H
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @brief Opt-in counters on the sponge hot paths.
+ *
+ * Built only with the `KECCAK_INSTRUMENTATION` option: otherwise the hooks are empty inline functions and the
+ * snapshot is all zeros. Each thread counts into its own block, which only it writes, so the hooks cost a few plain
+ * loads and stores; `snapshot()` sums the blocks of the live threads and of the ones that have exited.
+ */
+namespace keccak::instrumentation {
+
+/// Whether the library was built with the counters.
+#ifdef KECCAK_INSTRUMENTATION
+constexpr bool ENABLED = true;
+#else
+constexpr bool ENABLED = false;
+#endif
+
+/// The number of update size buckets: empty, then one bucket per power of eight up to 256 KiB, then larger.
+constexpr size_t SIZE_BUCKETS = 8;
+
+/**
+ * @brief The bucket of an update of a given size.
+ * @param length The number of bytes of the update.
+ * @return 0 for an empty update, k for [8^(k-1), 8^k) bytes, the last bucket for everything from 256 KiB on.
+ */
+constexpr inline size_t size_bucket(size_t length) {
+    if (length == 0) return 0;
+    const size_t bucket = (std::bit_width(length) + 2) / 3;
+    return bucket < SIZE_BUCKETS ? bucket : SIZE_BUCKETS - 1;
+}
+
+/**
+ * @brief The counter values, of one thread or aggregated.
+ */
+struct Counters {
+    /// The states permuted, each state of a multi-buffer permutation counting once.
+    uint64_t permutations;
+    /// The calls to the multi-buffer permutation.
+    uint64_t multi_buffer_calls;
+    /// The sponge updates.
+    uint64_t updates;
+    /// The bytes absorbed by sponge updates.
+    uint64_t bytes_absorbed;
+    /// The updates going through the byte-wise path for a partial word, before or after the whole words.
+    uint64_t partial_words;
+    /// The sponge updates by `size_bucket`.
+    std::array<uint64_t, SIZE_BUCKETS> update_sizes;
+};
+
+/**
+ * @brief Sum the counters of every thread since the start or the last reset.
+ * @return The counters, all zeros without `KECCAK_INSTRUMENTATION`.
+ */
+auto snapshot() -> Counters;
+
+/**
+ * @brief Start counting again from zero, as seen by later snapshots.
+ */
+void reset();
+
+namespace detail {
+
+/**
+ * @brief The counters of one thread, atomic only so that snapshots may read them while the thread counts.
+ */
+struct LocalCounters {
+    std::atomic<uint64_t> permutations;
+    std::atomic<uint64_t> multi_buffer_calls;
+    std::atomic<uint64_t> updates;
+    std::atomic<uint64_t> bytes_absorbed;
+    std::atomic<uint64_t> partial_words;
+    std::array<std::atomic<uint64_t>, SIZE_BUCKETS> update_sizes;
+};
+
+/**
+ * @brief The counters of the calling thread, registered for snapshots on first use.
+ */
+auto local() -> LocalCounters &;
+
+/**
+ * @brief Add to a counter only the owning thread writes, without a locked instruction.
+ */
+inline void add(std::atomic<uint64_t> &counter, uint64_t n) {
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+} // namespace detail
+
+/**
+ * @brief Count single-state permutations.
+ * @param n The number of permutations.
+ */
+constexpr inline void count_permutations([[maybe_unused]] uint64_t n) {
+#ifdef KECCAK_INSTRUMENTATION
+    if (!std::is_constant_evaluated()) detail::add(detail::local().permutations, n);
+#endif
+}
+
+/**
+ * @brief Count a multi-buffer permutation.
+ * @param lanes The number of states it permutes.
+ */
+constexpr inline void count_multi_buffer([[maybe_unused]] uint64_t lanes) {
+#ifdef KECCAK_INSTRUMENTATION
+    if (!std::is_constant_evaluated()) {
+        detail::LocalCounters &counters = detail::local();
+        detail::add(counters.permutations, lanes);
+        detail::add(counters.multi_buffer_calls, 1);
+    }
+#endif
+}
+
+/**
+ * @brief Count a sponge update.
+ * @param length The number of bytes of the update.
+ * @param partial Whether the update goes through the byte-wise path.
+ */
+constexpr inline void count_update([[maybe_unused]] size_t length, [[maybe_unused]] bool partial) {
+#ifdef KECCAK_INSTRUMENTATION
+    if (!std::is_constant_evaluated()) {
+        detail::LocalCounters &counters = detail::local();
+        detail::add(counters.updates, 1);
+        detail::add(counters.bytes_absorbed, length);
+        detail::add(counters.partial_words, partial);
+        detail::add(counters.update_sizes[size_bucket(length)], 1);
+    }
+#endif
+}
+
+} // namespace keccak::instrumentation
+
+#endif //KECCAK_INSTRUMENTATION_H
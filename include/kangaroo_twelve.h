@@ -0,0 +1,85 @@
+#ifndef KECCAK_KANGAROO_TWELVE_H
+#define KECCAK_KANGAROO_TWELVE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "turbo_shake.h"
+
+namespace keccak {
+
+/**
+ * @brief The KangarooTwelve extendable-output function (KT128, RFC 9861).
+ *
+ * Inputs longer than one chunk are hashed as a tree: the leaves are batched through the multi-buffer 12-round
+ * permutation, and their chaining values absorbed into the final node.
+ */
+class KangarooTwelve {
+public:
+    /// The size of a chunk in bytes.
+    static constexpr size_t CHUNK = 8192;
+    /// The size of a leaf chaining value in bytes.
+    static constexpr size_t CV_BYTES = 32;
+
+private:
+    /// The customization string C.
+    std::string customization;
+    /// The first chunk, while it may still be the whole input.
+    std::vector<uint8_t> first;
+    /// The leaves waiting for a full multi-buffer batch.
+    std::vector<uint8_t> leaves;
+    /// The number of leaves hashed so far.
+    uint64_t chunks;
+    /// Whether the input is longer than one chunk.
+    bool tree;
+    /// Whether the input has been finished and output squeezed.
+    bool squeezing;
+    /// The final node.
+    TurboSHAKE128 node;
+
+public:
+    /**
+     * @brief Initialize a KangarooTwelve instance.
+     * @param customization The customization string C.
+     */
+    explicit KangarooTwelve(std::string_view customization = {});
+
+    /**
+     * @brief Update the state with the input message.
+     * @param buf_in The input message.
+     * @param length The length of the input message.
+     */
+    void update(const void *buf_in, size_t length);
+
+    /**
+     * @brief Squeeze the next bytes of output, finishing the input on the first call.
+     * @param buf_out The output buffer.
+     * @param length The number of bytes to squeeze.
+     */
+    void squeeze(void *buf_out, size_t length);
+
+public:
+    /**
+     * @brief Single-shot KangarooTwelve.
+     * @param buf_in The input message.
+     * @param length The length of the input message.
+     * @param buf_out The output buffer.
+     * @param out_length The number of bytes to output.
+     * @param customization The customization string C.
+     */
+    static void hash_buffer(const void *buf_in, size_t length, void *buf_out, size_t out_length,
+                            std::string_view customization = {});
+
+private:
+    void absorb(const uint8_t *data, size_t length);
+
+    void hash_leaves(const uint8_t *data, size_t count);
+};
+
+using K12 = KangarooTwelve;
+
+} // namespace keccak
+
+#endif //KECCAK_KANGAROO_TWELVE_H
@@ -2,7 +2,12 @@
 #define KECCAK_KECCAK_H
 
 #include <array>
+#include <bit>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
 
 /**
  * @brief The keccak sponge function.
@@ -11,15 +16,59 @@ namespace keccak::core {
 
 constexpr size_t P_LEN = 25;
 
-/// The flag to use pure keccak instead of NIST-SHA3.
-constexpr uint64_t USE_KECCAK_FLAG = 0x80000000;
+#if defined(_MSC_VER)
+#define KECCAK_FORCE_INLINE __forceinline
+#else
+#define KECCAK_FORCE_INLINE inline __attribute__((always_inline))
+#endif
 
-constexpr inline uint64_t cw(uint64_t x) {
-    return (x) & (~USE_KECCAK_FLAG);
+constexpr KECCAK_FORCE_INLINE uint64_t rotl_64(uint64_t x, uint64_t y) {
+    return x << y | x >> (sizeof(uint64_t) * 8 - y);
 }
 
-constexpr inline uint64_t rotl_64(uint64_t x, uint64_t y) {
-    return x << y | x >> (sizeof(uint64_t) * 8 - y);
+/**
+ * @brief Load a little-endian word from possibly unaligned memory.
+ * @tparam Byte The byte type, `uint8_t`, `char` or `std::byte`, so that constant evaluation needs no pointer cast.
+ * @param p The first byte of the word.
+ * @return The word.
+ */
+template<typename Byte>
+constexpr KECCAK_FORCE_INLINE uint64_t load_le64(const Byte *p) {
+    static_assert(sizeof(Byte) == 1);
+    if (std::is_constant_evaluated() || std::endian::native != std::endian::little) {
+        uint64_t x = 0;
+        for (int i = 7; i >= 0; --i) x = x << 8 | static_cast<uint8_t>(p[i]);
+        return x;
+    }
+    uint64_t x;
+    std::memcpy(&x, p, sizeof(x));
+    return x;
+}
+
+/**
+ * @brief Store a word as little-endian bytes to possibly unaligned memory.
+ * @param p The first byte of the word.
+ * @param x The word.
+ */
+constexpr KECCAK_FORCE_INLINE void store_le64(uint8_t *p, uint64_t x) {
+    if (std::is_constant_evaluated() || std::endian::native != std::endian::little) {
+        for (int i = 0; i < 8; ++i) p[i] = static_cast<uint8_t>(x >> (8 * i));
+        return;
+    }
+    std::memcpy(p, &x, sizeof(x));
+}
+
+/**
+ * @brief Serialize a run of bytes of the state, lanes being little-endian.
+ * @param state The state.
+ * @param offset The first byte of the state to serialize.
+ * @param out The output buffer.
+ * @param length The number of bytes to serialize.
+ */
+constexpr inline void store_bytes(const std::array<uint64_t, P_LEN> &state, size_t offset, uint8_t *out, size_t length) {
+    for (; length > 0 && offset % 8 != 0; --length, ++offset) *out++ = static_cast<uint8_t>(state[offset / 8] >> (8 * (offset % 8)));
+    for (; length >= 8; length -= 8, offset += 8, out += 8) store_le64(out, state[offset / 8]);
+    for (; length > 0; --length, ++offset) *out++ = static_cast<uint8_t>(state[offset / 8] >> (8 * (offset % 8)));
 }
 
 constexpr uint64_t round_constants[24] = {
@@ -43,15 +92,24 @@ constexpr uint32_t pi[24] = {
         12, 2, 20, 14, 22, 9, 6, 1,
 };
 
+/// The number of rounds of keccak-f[1600].
+constexpr size_t ROUNDS = 24;
+
 /**
- * @brief The keccak sponge function.
+ * @brief The loop-based reference keccak-p[1600, n_r] permutation, taken from SHA3IUF.
+ *
+ * The rounds are the last `N_R` rounds of keccak-f[1600], e.g. 12 for KangarooTwelve.
+ * @tparam N_R The number of rounds.
  * @param state The state to operate on.
- * @return The state after the keccak function has been applied.
  */
-constexpr inline void keccak_p(std::array<uint64_t, core::P_LEN> &state) {
+template<size_t N_R = ROUNDS>
+constexpr inline void keccak_p_reference(std::array<uint64_t, core::P_LEN> &state) {
+    static_assert(N_R <= ROUNDS);
     uint64_t temp, bc[5];
 
-    for (uint64_t round: round_constants) {
+    for (size_t index = ROUNDS - N_R; index < ROUNDS; ++index) {
+        const uint64_t round = round_constants[index];
+
         // Theta
         for (int i = 0; i < 5; ++i) bc[i] = state[i] ^ state[i + 5] ^ state[i + 10] ^ state[i + 15] ^ state[i + 20];
         for (int i = 0; i < 5; ++i) {
@@ -81,6 +139,134 @@ constexpr inline void keccak_p(std::array<uint64_t, core::P_LEN> &state) {
     }
 }
 
+/// The lanes kept complemented by the lane-complementing permutation (be, bi, go, ki, mi, sa).
+constexpr size_t complemented_lanes[6] = {1, 2, 8, 12, 17, 20};
+
+/**
+ * @brief One unrolled keccak-f[1600] round on lane-complemented states.
+ *
+ * The lane naming follows the Keccak team's reference code: rows b, g, k, m, s and columns a, e, i, o, u.
+ * With the lanes of `complemented_lanes` stored inverted, Chi needs a single NOT per row instead of five.
+ * @param a The input state.
+ * @param e The output state.
+ * @param round The round constant.
+ */
+constexpr KECCAK_FORCE_INLINE void keccak_round(const uint64_t (&a)[P_LEN], uint64_t (&e)[P_LEN], uint64_t round) {
+    // Theta
+    const uint64_t ca = a[0] ^ a[5] ^ a[10] ^ a[15] ^ a[20];
+    const uint64_t ce = a[1] ^ a[6] ^ a[11] ^ a[16] ^ a[21];
+    const uint64_t ci = a[2] ^ a[7] ^ a[12] ^ a[17] ^ a[22];
+    const uint64_t co = a[3] ^ a[8] ^ a[13] ^ a[18] ^ a[23];
+    const uint64_t cu = a[4] ^ a[9] ^ a[14] ^ a[19] ^ a[24];
+
+    const uint64_t da = cu ^ rotl_64(ce, 1);
+    const uint64_t de = ca ^ rotl_64(ci, 1);
+    const uint64_t di = ce ^ rotl_64(co, 1);
+    const uint64_t do_ = ci ^ rotl_64(cu, 1);
+    const uint64_t du = co ^ rotl_64(ca, 1);
+
+    uint64_t ba, be, bi, bo, bu;
+
+    // Rho, Pi and Chi, one output row at a time
+    ba = a[0] ^ da;
+    be = rotl_64(a[6] ^ de, 44);
+    bi = rotl_64(a[12] ^ di, 43);
+    bo = rotl_64(a[18] ^ do_, 21);
+    bu = rotl_64(a[24] ^ du, 14);
+    e[0] = ba ^ (be | bi) ^ round;
+    e[1] = be ^ (~bi | bo);
+    e[2] = bi ^ (bo & bu);
+    e[3] = bo ^ (bu | ba);
+    e[4] = bu ^ (ba & be);
+
+    ba = rotl_64(a[3] ^ do_, 28);
+    be = rotl_64(a[9] ^ du, 20);
+    bi = rotl_64(a[10] ^ da, 3);
+    bo = rotl_64(a[16] ^ de, 45);
+    bu = rotl_64(a[22] ^ di, 61);
+    e[5] = ba ^ (be | bi);
+    e[6] = be ^ (bi & bo);
+    e[7] = bi ^ (bo | ~bu);
+    e[8] = bo ^ (bu | ba);
+    e[9] = bu ^ (ba & be);
+
+    ba = rotl_64(a[1] ^ de, 1);
+    be = rotl_64(a[7] ^ di, 6);
+    bi = rotl_64(a[13] ^ do_, 25);
+    bo = rotl_64(a[19] ^ du, 8);
+    bu = rotl_64(a[20] ^ da, 18);
+    e[10] = ba ^ (be | bi);
+    e[11] = be ^ (bi & bo);
+    e[12] = bi ^ (~bo & bu);
+    e[13] = ~bo ^ (bu | ba);
+    e[14] = bu ^ (ba & be);
+
+    ba = rotl_64(a[4] ^ du, 27);
+    be = rotl_64(a[5] ^ da, 36);
+    bi = rotl_64(a[11] ^ de, 10);
+    bo = rotl_64(a[17] ^ di, 15);
+    bu = rotl_64(a[23] ^ do_, 56);
+    e[15] = ba ^ (be & bi);
+    e[16] = be ^ (bi | bo);
+    e[17] = bi ^ (~bo | bu);
+    e[18] = ~bo ^ (bu & ba);
+    e[19] = bu ^ (ba | be);
+
+    ba = rotl_64(a[2] ^ di, 62);
+    be = rotl_64(a[8] ^ do_, 55);
+    bi = rotl_64(a[14] ^ du, 39);
+    bo = rotl_64(a[15] ^ da, 41);
+    bu = rotl_64(a[21] ^ de, 2);
+    e[20] = ba ^ (~be & bi);
+    e[21] = ~be ^ (bi | bo);
+    e[22] = bi ^ (bo & bu);
+    e[23] = bo ^ (bu | ba);
+    e[24] = bu ^ (ba & be);
+}
+
+template<size_t FIRST, size_t... I>
+constexpr KECCAK_FORCE_INLINE void keccak_rounds(uint64_t (&a)[P_LEN], uint64_t (&e)[P_LEN], std::index_sequence<I...>) {
+    ((keccak_round(a, e, round_constants[FIRST + 2 * I]), keccak_round(e, a, round_constants[FIRST + 2 * I + 1])), ...);
+}
+
+/**
+ * @brief The fully unrolled, lane-complementing keccak-p[1600, n_r] permutation.
+ *
+ * Always inlined, so the kernels built for other instruction sets never share an out-of-line copy.
+ * @tparam N_R The number of rounds, even.
+ * @param state The state to operate on.
+ */
+template<size_t N_R = ROUNDS>
+constexpr KECCAK_FORCE_INLINE void keccak_p_unrolled(std::array<uint64_t, core::P_LEN> &state) {
+    static_assert(N_R <= ROUNDS && N_R % 2 == 0);
+    uint64_t a[P_LEN]{}, e[P_LEN]{};
+
+    for (size_t i = 0; i < P_LEN; ++i) a[i] = state[i];
+    for (size_t i: complemented_lanes) a[i] = ~a[i];
+
+    keccak_rounds<ROUNDS - N_R>(a, e, std::make_index_sequence<N_R / 2>{});
+
+    for (size_t i: complemented_lanes) a[i] = ~a[i];
+    for (size_t i = 0; i < P_LEN; ++i) state[i] = a[i];
+}
+
+/**
+ * @brief The keccak sponge function.
+ *
+ * Defaults to the unrolled permutation; define `KECCAK_REFERENCE_PERMUTATION` to fall back to the reference one.
+ * @tparam N_R The number of rounds, 24 for keccak-f[1600].
+ * @param state The state to operate on.
+ * @return The state after the keccak function has been applied.
+ */
+template<size_t N_R = ROUNDS>
+constexpr inline void keccak_p(std::array<uint64_t, core::P_LEN> &state) {
+#ifdef KECCAK_REFERENCE_PERMUTATION
+    keccak_p_reference<N_R>(state);
+#else
+    keccak_p_unrolled<N_R>(state);
+#endif
+}
+
 } // namespace keccak::util
 
 #endif //KECCAK_KECCAK_H
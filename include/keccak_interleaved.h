@@ -0,0 +1,201 @@
+#ifndef KECCAK_KECCAK_INTERLEAVED_H
+#define KECCAK_KECCAK_INTERLEAVED_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "keccak.h"
+
+/**
+ * @brief The bit-interleaved keccak-p[1600] permutation for 32-bit targets.
+ *
+ * Every lane is kept as two 32-bit words, its even bits and its odd bits, so that a 64-bit rotation becomes two
+ * independent 32-bit rotations instead of shifts carrying across the halves. Lane `i` lives in words `2i` (even
+ * bits) and `2i + 1` (odd bits).
+ */
+namespace keccak::core {
+
+/// An interleaved state.
+using interleaved_state = std::array<uint32_t, 2 * P_LEN>;
+
+constexpr KECCAK_FORCE_INLINE uint32_t rotl_32(uint32_t x, uint32_t y) {
+    return x << y | x >> ((32 - y) & 31);
+}
+
+/**
+ * @brief Gather the even bits of a word into its low half and the odd bits into its high half.
+ */
+constexpr KECCAK_FORCE_INLINE uint32_t unshuffle_32(uint32_t x) {
+    uint32_t t;
+    t = (x ^ (x >> 1)) & 0x22222222;
+    x ^= t ^ (t << 1);
+    t = (x ^ (x >> 2)) & 0x0c0c0c0c;
+    x ^= t ^ (t << 2);
+    t = (x ^ (x >> 4)) & 0x00f000f0;
+    x ^= t ^ (t << 4);
+    t = (x ^ (x >> 8)) & 0x0000ff00;
+    x ^= t ^ (t << 8);
+    return x;
+}
+
+/**
+ * @brief The inverse of `unshuffle_32`.
+ */
+constexpr KECCAK_FORCE_INLINE uint32_t shuffle_32(uint32_t x) {
+    uint32_t t;
+    t = (x ^ (x >> 8)) & 0x0000ff00;
+    x ^= t ^ (t << 8);
+    t = (x ^ (x >> 4)) & 0x00f000f0;
+    x ^= t ^ (t << 4);
+    t = (x ^ (x >> 2)) & 0x0c0c0c0c;
+    x ^= t ^ (t << 2);
+    t = (x ^ (x >> 1)) & 0x22222222;
+    x ^= t ^ (t << 1);
+    return x;
+}
+
+/**
+ * @brief Split a lane given as its low and high words into its even and odd bits.
+ * @param low The low 32 bits of the lane.
+ * @param high The high 32 bits of the lane.
+ * @param even The even bits.
+ * @param odd The odd bits.
+ */
+constexpr KECCAK_FORCE_INLINE void interleave(uint32_t low, uint32_t high, uint32_t &even, uint32_t &odd) {
+    low = unshuffle_32(low);
+    high = unshuffle_32(high);
+    even = (low & 0x0000ffff) | (high << 16);
+    odd = (low >> 16) | (high & 0xffff0000);
+}
+
+/**
+ * @brief Merge the even and odd bits of a lane back into its low and high words.
+ * @param even The even bits.
+ * @param odd The odd bits.
+ * @param low The low 32 bits of the lane.
+ * @param high The high 32 bits of the lane.
+ */
+constexpr KECCAK_FORCE_INLINE void deinterleave(uint32_t even, uint32_t odd, uint32_t &low, uint32_t &high) {
+    low = shuffle_32((even & 0x0000ffff) | (odd << 16));
+    high = shuffle_32((even >> 16) | (odd & 0xffff0000));
+}
+
+/**
+ * @brief Convert a state to the interleaved form.
+ * @param state The state.
+ * @param out The interleaved state.
+ */
+constexpr inline void interleave(const std::array<uint64_t, P_LEN> &state, interleaved_state &out) {
+    for (size_t i = 0; i < P_LEN; ++i) {
+        const uint64_t lane = state[i];
+        interleave(static_cast<uint32_t>(lane), static_cast<uint32_t>(lane >> 32), out[2 * i], out[2 * i + 1]);
+    }
+}
+
+/**
+ * @brief Convert an interleaved state back.
+ * @param state The interleaved state.
+ * @param out The state.
+ */
+constexpr inline void deinterleave(const interleaved_state &state, std::array<uint64_t, P_LEN> &out) {
+    for (size_t i = 0; i < P_LEN; ++i) {
+        uint32_t low = 0, high = 0;
+        deinterleave(state[2 * i], state[2 * i + 1], low, high);
+        out[i] = static_cast<uint64_t>(high) << 32 | low;
+    }
+}
+
+/// The round constants, interleaved: the even bits of round `i` at `2i`, the odd bits at `2i + 1`.
+constexpr std::array<uint32_t, 2 * ROUNDS> interleaved_round_constants = [] {
+    std::array<uint32_t, 2 * ROUNDS> constants{};
+    for (size_t i = 0; i < ROUNDS; ++i) {
+        interleave(static_cast<uint32_t>(round_constants[i]), static_cast<uint32_t>(round_constants[i] >> 32),
+                   constants[2 * i], constants[2 * i + 1]);
+    }
+    return constants;
+}();
+
+/**
+ * @brief Rotate an interleaved lane left.
+ * @tparam N The rotation of the 64-bit lane.
+ */
+template<uint32_t N>
+constexpr KECCAK_FORCE_INLINE void rotl_interleaved(uint32_t &even, uint32_t &odd) {
+    if constexpr (N % 2 == 0) {
+        even = rotl_32(even, N / 2);
+        odd = rotl_32(odd, N / 2);
+    } else {
+        // The even bits move to odd positions and the odd bits to even ones, one place further.
+        const uint32_t t = rotl_32(odd, (N + 1) / 2);
+        odd = rotl_32(even, (N - 1) / 2);
+        even = t;
+    }
+}
+
+template<size_t... I>
+constexpr KECCAK_FORCE_INLINE void rho_pi_interleaved(interleaved_state &a, std::index_sequence<I...>) {
+    uint32_t even = a[2], odd = a[3];
+    (([&] {
+        constexpr uint32_t to = pi[I];
+        const uint32_t next_even = a[2 * to], next_odd = a[2 * to + 1];
+        rotl_interleaved<rotate_constants[I]>(even, odd);
+        a[2 * to] = even;
+        a[2 * to + 1] = odd;
+        even = next_even;
+        odd = next_odd;
+    }()), ...);
+}
+
+/**
+ * @brief The bit-interleaved keccak-p[1600, n_r] permutation.
+ * @tparam N_R The number of rounds, the last ones of keccak-f[1600].
+ * @param a The interleaved state to operate on.
+ */
+template<size_t N_R = ROUNDS>
+constexpr inline void keccak_p_interleaved(interleaved_state &a) {
+    static_assert(N_R <= ROUNDS);
+
+    for (size_t index = ROUNDS - N_R; index < ROUNDS; ++index) {
+        // Theta, on the even and odd halves of the column parities
+        uint32_t ce[5], co[5];
+        for (size_t x = 0; x < 5; ++x) {
+            ce[x] = a[2 * x] ^ a[2 * x + 10] ^ a[2 * x + 20] ^ a[2 * x + 30] ^ a[2 * x + 40];
+            co[x] = a[2 * x + 1] ^ a[2 * x + 11] ^ a[2 * x + 21] ^ a[2 * x + 31] ^ a[2 * x + 41];
+        }
+        for (size_t x = 0; x < 5; ++x) {
+            // D[x] = C[x - 1] ^ rotl(C[x + 1], 1), the rotation by one swapping the halves.
+            const uint32_t de = ce[(x + 4) % 5] ^ rotl_32(co[(x + 1) % 5], 1);
+            const uint32_t do_ = co[(x + 4) % 5] ^ ce[(x + 1) % 5];
+            for (size_t y = 0; y < 25; y += 5) {
+                a[2 * (x + y)] ^= de;
+                a[2 * (x + y) + 1] ^= do_;
+            }
+        }
+
+        // Rho and Pi
+        rho_pi_interleaved(a, std::make_index_sequence<24>{});
+
+        // Chi
+        for (size_t y = 0; y < 25; y += 5) {
+            uint32_t be[5], bo[5];
+            for (size_t x = 0; x < 5; ++x) {
+                be[x] = a[2 * (y + x)];
+                bo[x] = a[2 * (y + x) + 1];
+            }
+            for (size_t x = 0; x < 5; ++x) {
+                a[2 * (y + x)] = be[x] ^ (~be[(x + 1) % 5] & be[(x + 2) % 5]);
+                a[2 * (y + x) + 1] = bo[x] ^ (~bo[(x + 1) % 5] & bo[(x + 2) % 5]);
+            }
+        }
+
+        // Iota
+        a[0] ^= interleaved_round_constants[2 * index];
+        a[1] ^= interleaved_round_constants[2 * index + 1];
+    }
+}
+
+} // namespace keccak::core
+
+#endif //KECCAK_KECCAK_INTERLEAVED_H
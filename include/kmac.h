@@ -0,0 +1,126 @@
+#ifndef KECCAK_KMAC_H
+#define KECCAK_KMAC_H
+
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+#include "cshake.h"
+
+namespace keccak {
+
+/**
+ * @brief The KMAC message authentication code and its KMACXOF variant (NIST SP 800-185).
+ *
+ * The key is absorbed and padded to a whole block by the constructor, so a keyed instance is a ready midstate:
+ * copying it stamps out a MAC for the next message without permuting the key again.
+ *
+ * `finalize` is terminal and `squeeze` ends the input: in every build, updating after either, finalizing twice or
+ * mixing the two throws `std::logic_error` instead of absorbing into a padded state.
+ * @tparam BIT The security strength, 128 or 256.
+ */
+template<size_t BIT>
+class KMAC : private CSHAKE<BIT> {
+    /// What the instance is doing: still absorbing, finalized once, or squeezing KMACXOF output.
+    enum class Phase : uint8_t {
+        ABSORBING,
+        FINALIZED,
+        SQUEEZING,
+    };
+
+    Phase phase;
+
+public:
+    /**
+     * @brief Initialize a KMAC instance with its key.
+     * @param key The key K.
+     * @param key_length The length of the key in bytes.
+     * @param customization The customization string S.
+     */
+    constexpr KMAC(const void *key, size_t key_length, std::string_view customization = {});
+
+    /**
+     * @brief Update the state with the input message.
+     * @param buf_in The input message.
+     * @param length The length of the input message.
+     * @throws std::logic_error After `finalize` or `squeeze`.
+     */
+    constexpr void update(const void *buf_in, size_t length);
+
+    /**
+     * @brief Write the MAC, whose length is part of the MAC input; the instance is done afterwards.
+     * @param buf_out The output buffer.
+     * @param out_length The length of the MAC in bytes.
+     * @throws std::logic_error After `finalize` or `squeeze`.
+     */
+    constexpr void finalize(void *buf_out, size_t out_length);
+
+    /**
+     * @brief Squeeze the next bytes of KMACXOF output, finishing the input on the first call.
+     * @param buf_out The output buffer.
+     * @param length The number of bytes to squeeze.
+     * @throws std::logic_error After `finalize`.
+     */
+    constexpr void squeeze(void *buf_out, size_t length);
+
+public:
+    /**
+     * @brief Single-shot KMAC.
+     * @param key The key K.
+     * @param key_length The length of the key in bytes.
+     * @param buf_in The input message.
+     * @param length The length of the input message.
+     * @param buf_out The output buffer.
+     * @param out_length The length of the MAC in bytes.
+     * @param customization The customization string S.
+     */
+    constexpr static void hash_buffer(const void *key, size_t key_length, const void *buf_in, size_t length,
+                                      void *buf_out, size_t out_length, std::string_view customization = {});
+};
+
+using KMAC128 = KMAC<128>;
+using KMAC256 = KMAC<256>;
+
+template<size_t BIT>
+constexpr KMAC<BIT>::KMAC(const void *key, size_t key_length, std::string_view customization)
+        : CSHAKE<BIT>("KMAC", customization), phase{Phase::ABSORBING} {
+    size_t absorbed = core::left_encode(*this, CSHAKE<BIT>::RATE);
+    absorbed += core::encode_string(*this, key, key_length);
+    core::bytepad_zeros(*this, absorbed, CSHAKE<BIT>::RATE);
+}
+
+template<size_t BIT>
+constexpr void KMAC<BIT>::update(const void *buf_in, size_t length) {
+    if (this->phase != Phase::ABSORBING) throw std::logic_error("KMAC: update after finalize or squeeze");
+    CSHAKE<BIT>::update(buf_in, length);
+}
+
+template<size_t BIT>
+constexpr void KMAC<BIT>::finalize(void *buf_out, size_t out_length) {
+    if (this->phase != Phase::ABSORBING) throw std::logic_error("KMAC: finalize after finalize or squeeze");
+    core::right_encode(*this, static_cast<uint64_t>(out_length) * 8);
+    this->phase = Phase::FINALIZED;
+    CSHAKE<BIT>::squeeze(buf_out, out_length);
+}
+
+template<size_t BIT>
+constexpr void KMAC<BIT>::squeeze(void *buf_out, size_t length) {
+    if (this->phase == Phase::FINALIZED) throw std::logic_error("KMAC: squeeze after finalize");
+    if (this->phase == Phase::ABSORBING) {
+        core::right_encode(*this, 0);
+        this->phase = Phase::SQUEEZING;
+    }
+    CSHAKE<BIT>::squeeze(buf_out, length);
+}
+
+template<size_t BIT>
+constexpr void KMAC<BIT>::hash_buffer(const void *key, size_t key_length, const void *buf_in, size_t length,
+                                      void *buf_out, size_t out_length, std::string_view customization) {
+    KMAC kmac(key, key_length, customization);
+    kmac.update(buf_in, length);
+    kmac.finalize(buf_out, out_length);
+}
+
+} // namespace keccak
+
+#endif //KECCAK_KMAC_H
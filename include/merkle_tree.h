@@ -0,0 +1,92 @@
+#ifndef KECCAK_MERKLE_TREE_H
+#define KECCAK_MERKLE_TREE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "thread_pool.h"
+
+namespace keccak {
+
+/**
+ * @brief A binary Merkle tree over Keccak-256, where a parent is `Keccak256(left || right)`.
+ *
+ * The nodes are stored level by level in one flat array, from the leaves up to the root. A level of odd size
+ * promotes its last node unchanged to the level above. Levels are hashed with the multi-buffer permutation and,
+ * given a pool, split across its workers.
+ */
+class MerkleTree {
+public:
+    /// A leaf or an internal node.
+    using Node = std::array<uint8_t, 32>;
+    /// The smallest number of parents worth a task of their own.
+    static constexpr size_t MIN_TASK_NODES = 2048;
+
+private:
+    /// The nodes, level by level from the leaves to the root.
+    std::vector<Node> nodes;
+    /// The offset of each level in `nodes`, plus the total size.
+    std::vector<size_t> offsets;
+    /// The pool hashing the large levels, or null to hash on the calling thread.
+    ThreadPool *pool;
+
+public:
+    /**
+     * @brief Build the tree on the calling thread.
+     * @param leaves The leaves, at least one.
+     */
+    explicit MerkleTree(std::span<const Node> leaves);
+
+    /**
+     * @brief Build the tree, hashing the large levels on a pool.
+     * @param leaves The leaves, at least one.
+     * @param pool The pool, also used by later updates.
+     */
+    MerkleTree(std::span<const Node> leaves, ThreadPool &pool);
+
+    /**
+     * @brief The root of the tree.
+     * @return The root.
+     */
+    [[nodiscard]] auto root() const -> const Node &;
+
+    /**
+     * @brief The number of levels, 1 for a single leaf.
+     * @return The number of levels.
+     */
+    [[nodiscard]] auto depth() const -> size_t;
+
+    /**
+     * @brief The nodes of a level.
+     * @param level The level, 0 for the leaves.
+     * @return The nodes of the level.
+     */
+    [[nodiscard]] auto level(size_t level) const -> std::span<const Node>;
+
+    /**
+     * @brief Replace a leaf and recompute the nodes on its path to the root.
+     * @param index The index of the leaf.
+     * @param leaf The new leaf.
+     */
+    void update(size_t index, const Node &leaf);
+
+    /**
+     * @brief Hash one parent from its two children.
+     * @param left The left child.
+     * @param right The right child.
+     * @return The parent.
+     */
+    static auto hash_pair(const Node &left, const Node &right) -> Node;
+
+private:
+    MerkleTree(std::span<const Node> leaves, ThreadPool *pool);
+
+    void build(size_t level);
+};
+
+} // namespace keccak
+
+#endif //KECCAK_MERKLE_TREE_H
@@ -0,0 +1,52 @@
+#ifndef KECCAK_MULTI_BUFFER_H
+#define KECCAK_MULTI_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "keccak.h"
+
+/**
+ * @brief The multi-buffer keccak permutations, running several independent states in SIMD lanes.
+ *
+ * Multi-buffer states are interleaved: word `w` of state `i` lives at `states[w * lanes + i]`.
+ */
+namespace keccak::core {
+
+/// The widest multi-buffer permutation, in states.
+constexpr size_t MAX_LANES = 8;
+
+/**
+ * @brief The number of states the multi-buffer permutation of the selected kernel set runs at once.
+ * @return 8 with AVX-512, 4 with AVX2, 1 if the selected kernel set has no multi-buffer permutation or in the
+ *         reference build.
+ */
+auto multi_buffer_lanes() -> size_t;
+
+/**
+ * @brief Apply the keccak permutation to `lanes` interleaved states.
+ * @param states The interleaved states, `P_LEN * lanes` words.
+ * @param lanes The number of states, as returned by `multi_buffer_lanes()`.
+ * @param rounds The number of rounds, 24 or 12.
+ */
+void keccak_p_many(uint64_t *states, size_t lanes, size_t rounds = ROUNDS);
+
+/**
+ * @brief Apply the keccak permutation to 4 interleaved states with AVX2.
+ * @tparam N_R The number of rounds, 24 or 12.
+ * @param states The interleaved states, `P_LEN * 4` words.
+ */
+template<size_t N_R = ROUNDS>
+void keccak_p_x4(uint64_t *states);
+
+/**
+ * @brief Apply the keccak permutation to 8 interleaved states with AVX-512.
+ * @tparam N_R The number of rounds, 24 or 12.
+ * @param states The interleaved states, `P_LEN * 8` words.
+ */
+template<size_t N_R = ROUNDS>
+void keccak_p_x8(uint64_t *states);
+
+} // namespace keccak::core
+
+#endif //KECCAK_MULTI_BUFFER_H
@@ -0,0 +1,220 @@
+#ifndef KECCAK_MULTI_DIGEST_H
+#define KECCAK_MULTI_DIGEST_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+
+#include "dispatch.h"
+#include "keccak.h"
+#include "multi_buffer.h"
+#include "sponge.h"
+
+namespace keccak {
+
+/**
+ * @brief Several hashes of one input stream in a single pass.
+ *
+ * Sponges of the same rate absorb the same state and only differ in their final padding, so they share one state.
+ * The states of different rates read every chunk of the input while it is still in L1, and those with a whole
+ * block ready are permuted together in the lanes of the multi-buffer permutation.
+ * @tparam SPONGES The sponges, e.g. `SHA3Sponge<256>, Keccak256, SHA3Sponge<512>`.
+ */
+template<typename... SPONGES>
+class MultiDigest {
+    static_assert(sizeof...(SPONGES) > 0);
+
+public:
+    /// The hashes, in the order of the sponges.
+    using digests_type = std::tuple<typename SPONGES::digest_type...>;
+    /// The number of input bytes every state reads before moving on to the next chunk.
+    static constexpr size_t CHUNK = 16 << 10;
+
+private:
+    static constexpr size_t N_R = std::get<0>(std::make_tuple(SPONGES::N_ROUNDS...));
+    static_assert(((SPONGES::N_ROUNDS == N_R) && ...));
+
+    /// The number of distinct rates.
+    static constexpr size_t GROUPS = [] {
+        constexpr std::array<size_t, sizeof...(SPONGES)> rates = {SPONGES::RATE_BYTES...};
+        size_t count = 0;
+        for (size_t i = 0; i < rates.size(); ++i) {
+            count += std::find(rates.begin(), rates.begin() + i, rates[i]) == rates.begin() + i;
+        }
+        return count;
+    }();
+
+    /// The distinct rates in bytes, in order of first appearance.
+    static constexpr std::array<size_t, GROUPS> RATES = [] {
+        constexpr std::array<size_t, sizeof...(SPONGES)> rates = {SPONGES::RATE_BYTES...};
+        std::array<size_t, GROUPS> distinct{};
+        size_t count = 0;
+        for (const size_t rate: rates) {
+            if (std::find(distinct.begin(), distinct.begin() + count, rate) == distinct.begin() + count) {
+                distinct[count++] = rate;
+            }
+        }
+        return distinct;
+    }();
+
+    /**
+     * @brief The state shared by the sponges of one rate.
+     */
+    struct Group {
+        /// The state, at a block boundary.
+        std::array<uint64_t, core::P_LEN> state;
+        /// The input after the last whole block.
+        std::array<uint8_t, core::P_LEN * sizeof(uint64_t)> carry;
+        /// The number of bytes in `carry`.
+        size_t carried;
+    };
+
+    std::array<Group, GROUPS> groups;
+
+public:
+    /**
+     * @brief Initialize or reset the hashes.
+     */
+    constexpr MultiDigest();
+
+    /**
+     * @brief Update every hash with the input message.
+     * @param buf_in The input message.
+     * @param length The length of the input message.
+     */
+    void update(const void *buf_in, size_t length);
+
+    /**
+     * @brief Pad a copy of the states and return the hashes; the input can go on afterwards.
+     * @return The hashes, in the order of the sponges.
+     */
+    [[nodiscard]] auto digests() const -> digests_type;
+
+public:
+    /**
+     * @brief Single-shot multi-digest.
+     * @param buf_in The input message.
+     * @param length The length of the input message.
+     * @return The hashes, in the order of the sponges.
+     */
+    static auto hash_buffer(const void *buf_in, size_t length) -> digests_type;
+
+private:
+    /**
+     * @brief Absorb one chunk into every group, permuting the groups with a whole block ready together.
+     */
+    void absorb_chunk(const uint8_t *data, size_t length);
+
+    template<typename SPONGE>
+    auto digest() const -> typename SPONGE::digest_type;
+};
+
+using SHA3_256_Keccak256 = MultiDigest<SHA3Sponge<256>, Keccak256>;
+
+template<typename... SPONGES>
+constexpr MultiDigest<SPONGES...>::MultiDigest() : groups{} {}
+
+template<typename... SPONGES>
+void MultiDigest<SPONGES...>::update(const void *buf_in, size_t length) {
+    const auto *data = static_cast<const uint8_t *>(buf_in);
+    for (size_t offset = 0; offset < length; offset += MultiDigest::CHUNK) {
+        this->absorb_chunk(data + offset, std::min(MultiDigest::CHUNK, length - offset));
+    }
+}
+
+template<typename... SPONGES>
+void MultiDigest<SPONGES...>::absorb_chunk(const uint8_t *data, size_t length) {
+    const size_t lanes = core::multi_buffer_lanes();
+    std::array<size_t, GROUPS> cursors{};
+
+    while (true) {
+        // Every group takes its next whole block, topping up its carry first.
+        std::array<size_t, GROUPS> ready{};
+        size_t count = 0;
+        for (size_t g = 0; g < GROUPS; ++g) {
+            Group &group = this->groups[g];
+            const size_t rate = MultiDigest::RATES[g];
+            const uint8_t *block = nullptr;
+            if (group.carried > 0) {
+                const size_t n = std::min(rate - group.carried, length - cursors[g]);
+                std::copy_n(data + cursors[g], n, group.carry.begin() + group.carried);
+                cursors[g] += n;
+                group.carried += n;
+                if (group.carried == rate) {
+                    block = group.carry.data();
+                    group.carried = 0;
+                }
+            } else if (length - cursors[g] >= rate) {
+                block = data + cursors[g];
+                cursors[g] += rate;
+            }
+            if (block == nullptr) continue;
+            for (size_t i = 0; i < rate / sizeof(uint64_t); ++i) {
+                group.state[i] ^= core::load_le64(block + i * sizeof(uint64_t));
+            }
+            ready[count++] = g;
+        }
+        if (count == 0) break;
+
+        if (count == 1 || lanes < count) {
+            for (size_t i = 0; i < count; ++i) core::permute<N_R>(this->groups[ready[i]].state);
+            continue;
+        }
+        std::array<uint64_t, core::P_LEN * core::MAX_LANES> states{};
+        for (size_t lane = 0; lane < count; ++lane) {
+            const auto &state = this->groups[ready[lane]].state;
+            for (size_t i = 0; i < core::P_LEN; ++i) states[i * lanes + lane] = state[i];
+        }
+        core::keccak_p_many(states.data(), lanes, N_R);
+        for (size_t lane = 0; lane < count; ++lane) {
+            auto &state = this->groups[ready[lane]].state;
+            for (size_t i = 0; i < core::P_LEN; ++i) state[i] = states[i * lanes + lane];
+        }
+    }
+
+    // What is left of the chunk is shorter than a block.
+    for (size_t g = 0; g < GROUPS; ++g) {
+        Group &group = this->groups[g];
+        const size_t n = length - cursors[g];
+        std::copy_n(data + cursors[g], n, group.carry.begin() + group.carried);
+        group.carried += n;
+    }
+}
+
+template<typename... SPONGES>
+auto MultiDigest<SPONGES...>::digests() const -> digests_type {
+    return {this->template digest<SPONGES>()...};
+}
+
+template<typename... SPONGES>
+template<typename SPONGE>
+auto MultiDigest<SPONGES...>::digest() const -> typename SPONGE::digest_type {
+    constexpr size_t RATE = SPONGE::RATE_BYTES;
+    constexpr auto g = std::find(MultiDigest::RATES.begin(), MultiDigest::RATES.end(), RATE) - MultiDigest::RATES.begin();
+    const Group &group = this->groups[g];
+
+    auto state = group.state;
+    std::array<uint8_t, RATE> last{};
+    std::copy_n(group.carry.begin(), group.carried, last.begin());
+    last[group.carried] ^= SPONGE::DOMAIN_BYTE;
+    last[RATE - 1] ^= 0x80;
+    for (size_t i = 0; i < SPONGE::RATE_WORDS; ++i) state[i] ^= core::load_le64(last.data() + i * sizeof(uint64_t));
+    core::permute<N_R>(state);
+
+    typename SPONGE::digest_type out{};
+    core::store_bytes(state, 0, out.data(), out.size());
+    return out;
+}
+
+template<typename... SPONGES>
+auto MultiDigest<SPONGES...>::hash_buffer(const void *buf_in, size_t length) -> digests_type {
+    MultiDigest multi;
+    multi.update(buf_in, length);
+    return multi.digests();
+}
+
+} // namespace keccak
+
+#endif //KECCAK_MULTI_DIGEST_H
@@ -0,0 +1,173 @@
+#ifndef KECCAK_PARALLEL_HASH_H
+#define KECCAK_PARALLEL_HASH_H
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "cshake.h"
+#include "thread_pool.h"
+
+namespace keccak {
+
+/**
+ * @brief The ParallelHash function (NIST SP 800-185), hashing its blocks on a thread pool.
+ *
+ * Input is gathered into tasks of whole blocks that the pool hashes while more input arrives. The chaining values
+ * are absorbed in order into the final cSHAKE as soon as the oldest task is done.
+ * @tparam BIT The security strength, 128 or 256.
+ */
+template<size_t BIT>
+class ParallelHash {
+public:
+    /// The size of a chaining value in bytes.
+    static constexpr size_t CV_BYTES = 2 * BIT / 8;
+    /// The least amount of input in one task, so that small blocks do not drown in scheduling.
+    static constexpr size_t MIN_TASK_BYTES = 64 * 1024;
+
+private:
+    /// The pool owned by this instance, if it was not given one.
+    std::unique_ptr<ThreadPool> owned_pool;
+    /// The pool hashing the blocks.
+    ThreadPool *pool;
+    /// The block size B in bytes.
+    size_t block_size;
+    /// The input size of a full task, a multiple of the block size.
+    size_t task_size;
+    /// The number of blocks submitted so far.
+    uint64_t blocks;
+    /// The input of the next task.
+    std::vector<uint8_t> buffer;
+    /// The chaining values of the submitted tasks, oldest first.
+    std::deque<std::future<std::vector<uint8_t>>> pending;
+    /// The final sponge, absorbing the chaining values.
+    CSHAKE<BIT> outer;
+
+public:
+    /**
+     * @brief Initialize a ParallelHash instance running on a shared pool.
+     * @param block_size The block size B in bytes.
+     * @param customization The customization string S.
+     * @param pool The pool hashing the blocks.
+     */
+    ParallelHash(size_t block_size, std::string_view customization, ThreadPool &pool);
+
+    /**
+     * @brief Initialize a ParallelHash instance with its own pool.
+     * @param block_size The block size B in bytes.
+     * @param customization The customization string S.
+     * @param workers The number of workers, 0 for one per hardware thread.
+     */
+    explicit ParallelHash(size_t block_size, std::string_view customization = {}, size_t workers = 0);
+
+    /**
+     * @brief Update the state with the input message, handing every full task to the pool.
+     * @param buf_in The input message.
+     * @param length The length of the input message.
+     */
+    void update(const void *buf_in, size_t length);
+
+    /**
+     * @brief Wait for the pending blocks and write the hash.
+     * @param buf_out The output buffer.
+     * @param out_length The length of the hash in bytes, which is part of the hash input.
+     */
+    void finalize(void *buf_out, size_t out_length);
+
+private:
+    ParallelHash(size_t block_size, std::string_view customization, ThreadPool *pool,
+                 std::unique_ptr<ThreadPool> owned_pool);
+
+    void submit();
+
+    void drain(size_t max_pending);
+};
+
+using ParallelHash128 = ParallelHash<128>;
+using ParallelHash256 = ParallelHash<256>;
+
+template<size_t BIT>
+ParallelHash<BIT>::ParallelHash(size_t block_size, std::string_view customization, ThreadPool &pool)
+        : ParallelHash(block_size, customization, &pool, nullptr) {}
+
+template<size_t BIT>
+ParallelHash<BIT>::ParallelHash(size_t block_size, std::string_view customization, size_t workers)
+        : ParallelHash(block_size, customization, nullptr, std::make_unique<ThreadPool>(workers)) {}
+
+template<size_t BIT>
+ParallelHash<BIT>::ParallelHash(size_t block_size, std::string_view customization, ThreadPool *pool,
+                                std::unique_ptr<ThreadPool> owned_pool)
+        : owned_pool{std::move(owned_pool)}, pool{pool != nullptr ? pool : this->owned_pool.get()},
+          block_size{block_size},
+          task_size{block_size * std::max<size_t>(1, ParallelHash::MIN_TASK_BYTES / block_size)}, blocks{0},
+          buffer{}, pending{}, outer{"ParallelHash", customization} {
+    assert(block_size > 0);
+    this->buffer.reserve(this->task_size);
+    core::left_encode(this->outer, block_size);
+}
+
+template<size_t BIT>
+void ParallelHash<BIT>::update(const void *buf_in, size_t length) {
+    const auto *data = static_cast<const uint8_t *>(buf_in);
+    while (length > 0) {
+        const size_t n = std::min(length, this->task_size - this->buffer.size());
+        this->buffer.insert(this->buffer.end(), data, data + n);
+        data += n;
+        length -= n;
+        if (this->buffer.size() == this->task_size) this->submit();
+    }
+}
+
+template<size_t BIT>
+void ParallelHash<BIT>::finalize(void *buf_out, size_t out_length) {
+    if (!this->buffer.empty()) this->submit();
+    this->drain(0);
+
+    core::right_encode(this->outer, this->blocks);
+    core::right_encode(this->outer, static_cast<uint64_t>(out_length) * 8);
+    this->outer.squeeze(buf_out, out_length);
+}
+
+template<size_t BIT>
+void ParallelHash<BIT>::submit() {
+    const size_t block_size = this->block_size;
+    this->blocks += (this->buffer.size() + block_size - 1) / block_size;
+    this->pending.push_back(this->pool->submit([data = std::move(this->buffer), block_size] {
+        const size_t count = (data.size() + block_size - 1) / block_size;
+        std::vector<uint8_t> cvs(count * ParallelHash::CV_BYTES);
+        for (size_t i = 0; i < count; ++i) {
+            const size_t offset = i * block_size;
+            SHAKE<BIT>::hash_buffer(data.data() + offset, std::min(block_size, data.size() - offset),
+                                    cvs.data() + i * ParallelHash::CV_BYTES, ParallelHash::CV_BYTES);
+        }
+        return cvs;
+    }));
+
+    this->buffer = {};
+    this->buffer.reserve(this->task_size);
+    // Keep every worker fed without letting the queued input grow without bound.
+    this->drain(2 * this->pool->size());
+}
+
+template<size_t BIT>
+void ParallelHash<BIT>::drain(size_t max_pending) {
+    while (!this->pending.empty()) {
+        auto &front = this->pending.front();
+        if (this->pending.size() <= max_pending && front.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            return;
+        }
+        const auto cvs = front.get();
+        this->outer.update(cvs.data(), cvs.size());
+        this->pending.pop_front();
+    }
+}
+
+} // namespace keccak
+
+#endif //KECCAK_PARALLEL_HASH_H
@@ -3,32 +3,42 @@
 
 #include <array>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
+#include <optional>
+#include <span>
 
-#include "keccak.h"
+#include "sponge.h"
 
 namespace keccak {
 
 /**
- * @brief The SHA3 hasher.
+ * @brief The SHA3 hasher, choosing between NIST-SHA3 and Keccak padding at runtime.
+ *
+ * A thin compatibility layer over the NIST-SHA3 sponge: only the final padding looks at the flag. The sponge is a
+ * protected base, so that a Keccak hasher never passes for a NIST one and the NIST-only members stay hidden. Prefer
+ * SHA3Sponge or KeccakSponge when the variant is known at compile time.
  * @tparam BIT The bit length of the hash output.
+ * @tparam N_R The number of permutation rounds.
  */
-template<size_t BIT>
-class SHA3 {
+template<size_t BIT, size_t N_R = core::ROUNDS>
+class SHA3 : protected SHA3Sponge<BIT, N_R> {
+    using Base = SHA3Sponge<BIT, N_R>;
+
 public:
-    static constexpr size_t SPONGE_WORDS = 1600 / 8 / sizeof(uint64_t);
+    using Base::SPONGE_WORDS;
+    using Base::RATE_BYTES;
+    using Base::RATE_WORDS;
+    using Base::N_ROUNDS;
+    using Base::SERIAL_BYTES;
+    using typename Base::digest_type;
+    using typename Base::serial_type;
+
+    using Base::update;
 
 private:
-    /// The portion of the input message that have not been processed yet.
-    uint64_t saved;
-    /// The next byte after the set one.
-    uint32_t byte_index;
-    /// The next word to integrate input.
-    uint32_t word_index;
-    /// The double size of the hash output in words (e.g., 16 for Keccak-512).
-    uint32_t capacity_words;
-    /// The state of the sponge.
-    std::array<uint64_t, SHA3::SPONGE_WORDS> state;
+    /// The domain padding byte picked by the flag.
+    uint8_t domain;
 
 public:
     /**
@@ -38,18 +48,35 @@ public:
     constexpr explicit SHA3(uint8_t flag = 0);
 
     /**
-     * @brief Update the state of the sponge with the input message.
-     * @param buf_in The input message.
-     * @param length The length of the input message.
-     * @return The updated state of the sponge.
+     * @brief Finalize the sponge and return the hash.
+     * @return The hash.
      */
-    constexpr void update(const void *buf_in, size_t length);
+    constexpr auto finalize() -> std::array<uint64_t, SHA3::SPONGE_WORDS>;
 
     /**
-     * @brief Finalize the sponge and return the hash.
+     * @brief Finalize the sponge and write only the hash into caller memory.
+     * @param out The hash.
+     */
+    void finalize_into(std::span<std::byte, BIT / 8> out);
+
+    /**
+     * @brief Finalize the sponge and return only the hash.
      * @return The hash.
      */
-    constexpr auto finalize() -> std::array<uint64_t, SHA3::SPONGE_WORDS>;
+    constexpr auto digest() -> digest_type;
+
+    /**
+     * @brief Serialize the whole context, the padding picked by the flag included.
+     * @return The serialized context.
+     */
+    constexpr auto serialize() const -> serial_type;
+
+    /**
+     * @brief Resume a serialized context of either padding.
+     * @param data The serialized context.
+     * @return The hasher, or nothing if the context is malformed, of another version or of another variant.
+     */
+    constexpr static auto deserialize(std::span<const std::byte> data) -> std::optional<SHA3>;
 
 public:
     /**
@@ -60,94 +87,149 @@ public:
      * @return The hash.
      */
     constexpr static auto hash_buffer(const void *buf_in, uint32_t length, int flag) -> std::array<uint64_t, SHA3::SPONGE_WORDS>;
-};
 
-template<size_t BIT>
-constexpr SHA3<BIT>::SHA3(uint8_t flag)
-        : saved{0}, byte_index{0}, word_index{0}, capacity_words{2 * BIT / (8 * sizeof(uint64_t))}, state{} {
-    assert(BIT == 256 || BIT == 384 || BIT == 512);
-    this->capacity_words |= (flag == 1 ? core::USE_KECCAK_FLAG : 0);
-}
-
-template<size_t BIT>
-constexpr void SHA3<BIT>::update(const void *buf_in, size_t length) {
-    uint32_t old_tail = (8 - this->byte_index) & 7;
+    /**
+     * @brief Single-shot hash function returning only the hash.
+     * @param buf_in The input message.
+     * @param length The length of the input message.
+     * @param flag The SHA3 flag, 0 for NIST-SHA3, 1 for Keccak.
+     * @return The hash.
+     */
+    constexpr static auto hash_digest(const void *buf_in, size_t length, int flag = 0) -> digest_type;
 
-    size_t words;
-    uint32_t tail;
+    /**
+     * @brief Single-shot hash function returning only the hash, also in constant evaluation.
+     * @param data The input message.
+     * @param flag The SHA3 flag, 0 for NIST-SHA3, 1 for Keccak.
+     * @return The hash.
+     */
+    constexpr static auto hash_digest(std::span<const std::byte> data, int flag = 0) -> digest_type;
 
-    const auto *buffer = static_cast<const uint8_t *>(buf_in);
+    /**
+     * @brief Single-shot hash of a message scattered over several fragments.
+     * @param fragments The fragments of the input message, in order.
+     * @param flag The SHA3 flag, 0 for NIST-SHA3, 1 for Keccak.
+     * @return The hash.
+     */
+    constexpr static auto hash_digest(std::span<const std::span<const std::byte>> fragments, int flag = 0)
+            -> digest_type;
 
-    assert(this->byte_index < 8);
-    assert(this->word_index < SHA3::SPONGE_WORDS);
+    /**
+     * @brief Single-shot hash of a message shorter than the rate whose length is known at compile time.
+     * @tparam N The length of the input message, less than the rate.
+     * @param buf_in The input message.
+     * @param flag The SHA3 flag, 0 for NIST-SHA3, 1 for Keccak.
+     * @return The hash.
+     */
+    template<size_t N>
+    static auto hash_fixed(const void *buf_in, int flag = 0) -> digest_type;
 
-    if (length < old_tail) {
-        while (length--) this->saved |= static_cast<uint64_t>(*buffer++) << ((this->byte_index++) * 8);
-        assert(this->byte_index < 8);
-        return;
-    }
+    /**
+     * @brief Single-shot hash of a message shorter than the rate, also in constant evaluation.
+     * @tparam N The length of the input message, less than the rate.
+     * @param data The input message.
+     * @param flag The SHA3 flag, 0 for NIST-SHA3, 1 for Keccak.
+     * @return The hash.
+     */
+    template<size_t N>
+    constexpr static auto hash_fixed(std::span<const std::byte, N> data, int flag = 0) -> digest_type;
 
-    if (old_tail) {
-        length -= old_tail;
-        while (old_tail--) this->saved |= static_cast<uint64_t>(*buffer++) << ((this->byte_index++) * 8);
-        this->state[this->word_index] ^= this->saved;
-        assert(this->byte_index == 8);
-        this->byte_index = 0;
-        this->saved = 0;
-        if (++this->word_index == (SHA3::SPONGE_WORDS - core::cw(this->capacity_words))) {
-            core::keccak_p(this->state);
-            this->word_index = 0;
-        }
-    }
-    assert(this->byte_index == 0);
-
-    words = length / sizeof(uint64_t);
-    tail = length - words * sizeof(uint64_t);
-
-    for (int i = 0; i < words; ++i, buffer += sizeof(uint64_t)) {
-        const uint64_t t =
-                (uint64_t) (buffer[0]) |
-                ((uint64_t) (buffer[1]) << 8 * 1) | ((uint64_t) (buffer[2]) << 8 * 2) |
-                ((uint64_t) (buffer[3]) << 8 * 3) | ((uint64_t) (buffer[4]) << 8 * 4) |
-                ((uint64_t) (buffer[5]) << 8 * 5) | ((uint64_t) (buffer[6]) << 8 * 6) |
-                ((uint64_t) (buffer[7]) << 8 * 7);
-
-        this->state[this->word_index] ^= t;
-        if (++this->word_index == (SHA3::SPONGE_WORDS - core::cw(this->capacity_words))) {
-            core::keccak_p(this->state);
-            this->word_index = 0;
-        }
-    }
+    /**
+     * @brief Hash many independent messages, running several of them at once with the multi-buffer permutation.
+     * @param buffers The input messages.
+     * @param digests The hashes, one per input message.
+     * @param flag The SHA3 flag, 0 for NIST-SHA3, 1 for Keccak.
+     * @throws std::invalid_argument If there are not as many hashes as input messages.
+     */
+    static void hash_many(std::span<const std::span<const uint8_t>> buffers,
+                          std::span<digest_type> digests, int flag = 0);
+};
 
-    assert(this->byte_index == 0 && tail < 8);
-    while (tail--) {
-        this->saved |= static_cast<uint64_t>(*buffer++) << ((this->byte_index++) * 8);
-    }
-    assert(this->byte_index < 8);
+template<size_t BIT, size_t N_R>
+constexpr SHA3<BIT, N_R>::SHA3(uint8_t flag) : Base(), domain{static_cast<uint8_t>(flag == 1 ? 0x01 : 0x06)} {
+    assert(BIT == 224 || BIT == 256 || BIT == 384 || BIT == 512);
 }
 
-template<size_t BIT>
-constexpr std::array<uint64_t, SHA3<BIT>::SPONGE_WORDS> SHA3<BIT>::finalize() {
-    uint64_t t;
-    if (this->capacity_words & core::USE_KECCAK_FLAG) {
-        t = static_cast<uint64_t>((static_cast<uint64_t>(1) << (this->byte_index * 8)));
-    } else {
-        t = static_cast<uint64_t>((static_cast<uint64_t>((0x02 | 1 << 2)) << (this->byte_index * 8)));
-    }
-    this->state[this->word_index] ^= this->saved ^ t;
-    this->state[SHA3::SPONGE_WORDS - core::cw(this->capacity_words) - 1] ^= 0x8000000000000000ULL;
-    core::keccak_p(this->state);
+template<size_t BIT, size_t N_R>
+constexpr std::array<uint64_t, SHA3<BIT, N_R>::SPONGE_WORDS> SHA3<BIT, N_R>::finalize() {
+    this->pad(this->domain);
     return this->state;
 }
 
-template<size_t BIT>
-std::array<uint64_t, SHA3<BIT>::SPONGE_WORDS>
-constexpr SHA3<BIT>::hash_buffer(const void *buf_in, uint32_t length, int flag) {
-    SHA3<BIT> sha3(flag);
+template<size_t BIT, size_t N_R>
+void SHA3<BIT, N_R>::finalize_into(std::span<std::byte, BIT / 8> out) {
+    this->pad(this->domain);
+    SHA3::store_digest(this->state.data(), 1, reinterpret_cast<uint8_t *>(out.data()));
+}
+
+template<size_t BIT, size_t N_R>
+constexpr auto SHA3<BIT, N_R>::digest() -> digest_type {
+    digest_type out{};
+    this->pad(this->domain);
+    SHA3::store_digest(this->state.data(), 1, out.data());
+    return out;
+}
+
+template<size_t BIT, size_t N_R>
+constexpr auto SHA3<BIT, N_R>::serialize() const -> serial_type {
+    return Base::serialize(this->domain);
+}
+
+template<size_t BIT, size_t N_R>
+constexpr auto SHA3<BIT, N_R>::deserialize(std::span<const std::byte> data) -> std::optional<SHA3> {
+    SHA3 sha3;
+    uint8_t domain = 0;
+    if (!sha3.Base::deserialize(data, domain) || (domain != 0x01 && domain != 0x06)) return std::nullopt;
+    sha3.domain = domain;
+    return sha3;
+}
+
+template<size_t BIT, size_t N_R>
+std::array<uint64_t, SHA3<BIT, N_R>::SPONGE_WORDS>
+constexpr SHA3<BIT, N_R>::hash_buffer(const void *buf_in, uint32_t length, int flag) {
+    SHA3 sha3(flag);
     sha3.update(buf_in, length);
     return sha3.finalize();
 }
 
+template<size_t BIT, size_t N_R>
+constexpr auto SHA3<BIT, N_R>::hash_digest(const void *buf_in, size_t length, int flag) -> digest_type {
+    return flag == 1 ? KeccakSponge<BIT, N_R>::hash_digest(buf_in, length) : Base::hash_digest(buf_in, length);
+}
+
+template<size_t BIT, size_t N_R>
+constexpr auto SHA3<BIT, N_R>::hash_digest(std::span<const std::byte> data, int flag) -> digest_type {
+    return flag == 1 ? KeccakSponge<BIT, N_R>::hash_digest(data) : Base::hash_digest(data);
+}
+
+template<size_t BIT, size_t N_R>
+constexpr auto SHA3<BIT, N_R>::hash_digest(std::span<const std::span<const std::byte>> fragments, int flag)
+        -> digest_type {
+    return flag == 1 ? KeccakSponge<BIT, N_R>::hash_digest(fragments) : Base::hash_digest(fragments);
+}
+
+template<size_t BIT, size_t N_R>
+template<size_t N>
+auto SHA3<BIT, N_R>::hash_fixed(const void *buf_in, int flag) -> digest_type {
+    return flag == 1 ? KeccakSponge<BIT, N_R>::template hash_fixed<N>(buf_in) : Base::template hash_fixed<N>(buf_in);
+}
+
+template<size_t BIT, size_t N_R>
+template<size_t N>
+constexpr auto SHA3<BIT, N_R>::hash_fixed(std::span<const std::byte, N> data, int flag) -> digest_type {
+    return flag == 1 ? KeccakSponge<BIT, N_R>::hash_fixed(data) : Base::hash_fixed(data);
+}
+
+template<size_t BIT, size_t N_R>
+void SHA3<BIT, N_R>::hash_many(std::span<const std::span<const uint8_t>> buffers,
+                               std::span<digest_type> digests, int flag) {
+    if (flag == 1) {
+        KeccakSponge<BIT, N_R>::hash_many(buffers, digests);
+    } else {
+        Base::hash_many(buffers, digests);
+    }
+}
+
 } // namespace keccak
 
-#endif //KECCAK_SHA3_H
\ No newline at end of file
+#endif //KECCAK_SHA3_H
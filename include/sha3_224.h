@@ -0,0 +1,17 @@
+#ifndef KECCAK_SHA3_224_H
+#define KECCAK_SHA3_224_H
+
+#include <cassert>
+
+#include "sha3.h"
+
+namespace keccak {
+
+class SHA3_224 : public SHA3<224> {
+public:
+    explicit SHA3_224(uint8_t flag = 0);
+};
+
+} // namespace keccak
+
+#endif //KECCAK_SHA3_224_H
\ No newline at end of file
@@ -0,0 +1,121 @@
+#ifndef KECCAK_SHAKE_H
+#define KECCAK_SHAKE_H
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+#include "sponge.h"
+
+namespace keccak {
+
+/**
+ * @brief The SHAKE extendable-output function, built on the Keccak sponge.
+ * @tparam BIT The security strength, 128 or 256.
+ * @tparam N_R The number of permutation rounds, 24 except for TurboSHAKE.
+ */
+template<size_t BIT, size_t N_R = core::ROUNDS>
+class SHAKE : private Sponge<200 - BIT / 4, 0x1f, N_R> {
+    using Base = Sponge<200 - BIT / 4, 0x1f, N_R>;
+
+public:
+    /// The rate of the sponge in bytes, the size of one squeezed block.
+    static constexpr size_t RATE = 200 - BIT / 4;
+
+private:
+    /// The next byte of the current output block to squeeze.
+    uint32_t squeeze_index;
+    /// Whether the input has been padded and output squeezed.
+    bool squeezing;
+    /// The domain padding byte.
+    uint8_t domain;
+
+protected:
+    /**
+     * @brief Initialize a sponge with another domain padding byte, for cSHAKE and friends.
+     * @param domain The domain padding byte.
+     */
+    constexpr explicit SHAKE(uint8_t domain);
+
+public:
+    /**
+     * @brief Initialize or reset a SHAKE instance.
+     */
+    constexpr SHAKE();
+
+    /**
+     * @brief Update the state of the sponge with the input message.
+     * @param buf_in The input message.
+     * @param length The length of the input message.
+     */
+    constexpr void update(const void *buf_in, size_t length);
+
+    /**
+     * @brief Squeeze the next bytes of output, finishing the input on the first call.
+     * @param buf_out The output buffer.
+     * @param length The number of bytes to squeeze.
+     */
+    constexpr void squeeze(void *buf_out, size_t length);
+
+public:
+    /**
+     * @brief Single-shot extendable-output function.
+     * @param buf_in The input message.
+     * @param length The length of the input message.
+     * @param buf_out The output buffer.
+     * @param out_length The number of bytes to output.
+     */
+    constexpr static void hash_buffer(const void *buf_in, size_t length, void *buf_out, size_t out_length);
+};
+
+using SHAKE128 = SHAKE<128>;
+using SHAKE256 = SHAKE<256>;
+
+template<size_t BIT, size_t N_R>
+constexpr SHAKE<BIT, N_R>::SHAKE(uint8_t domain)
+        : Base(), squeeze_index{0}, squeezing{false}, domain{domain} {
+    assert(BIT == 128 || BIT == 256);
+}
+
+template<size_t BIT, size_t N_R>
+constexpr SHAKE<BIT, N_R>::SHAKE() : SHAKE(0x1f) {}
+
+template<size_t BIT, size_t N_R>
+constexpr void SHAKE<BIT, N_R>::update(const void *buf_in, size_t length) {
+    assert(!this->squeezing);
+    Base::update(buf_in, length);
+}
+
+template<size_t BIT, size_t N_R>
+constexpr void SHAKE<BIT, N_R>::squeeze(void *buf_out, size_t length) {
+    auto *buffer = static_cast<uint8_t *>(buf_out);
+
+    if (!this->squeezing) {
+        this->pad(this->domain);
+        this->squeezing = true;
+    }
+
+    while (length > 0) {
+        if (this->squeeze_index == SHAKE::RATE) {
+            core::permute<N_R>(this->state);
+            this->squeeze_index = 0;
+        }
+        const size_t n = std::min<size_t>(length, SHAKE::RATE - this->squeeze_index);
+        core::store_bytes(this->state, this->squeeze_index, buffer, n);
+        this->squeeze_index += n;
+        buffer += n;
+        length -= n;
+    }
+}
+
+template<size_t BIT, size_t N_R>
+constexpr void SHAKE<BIT, N_R>::hash_buffer(const void *buf_in, size_t length, void *buf_out, size_t out_length) {
+    SHAKE shake;
+    shake.update(buf_in, length);
+    shake.squeeze(buf_out, out_length);
+}
+
+} // namespace keccak
+
+#endif //KECCAK_SHAKE_H
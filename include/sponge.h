@@ -0,0 +1,676 @@
+#ifndef KECCAK_SPONGE_H
+#define KECCAK_SPONGE_H
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "dispatch.h"
+#include "instrumentation.h"
+#include "keccak.h"
+#include "multi_buffer.h"
+
+namespace keccak {
+
+/**
+ * @brief The Keccak sponge with its rate and padding fixed at compile time.
+ *
+ * The rate boundary and the padding byte are constants, so the absorb loop and the final padding are folded for
+ * each variant instead of testing a runtime flag. Sponges are plain values: copying one that has absorbed a shared
+ * prefix stamps out new hashers without absorbing the prefix again.
+ * @tparam RATE The rate of the sponge in bytes, a multiple of 8.
+ * @tparam DOMAIN The domain padding byte, 0x06 for NIST-SHA3 or 0x01 for Keccak.
+ * @tparam N_R The number of permutation rounds, 24 except for the reduced-round TurboSHAKE family.
+ */
+template<size_t RATE, uint8_t DOMAIN, size_t N_R = core::ROUNDS>
+class Sponge {
+    static_assert(RATE % sizeof(uint64_t) == 0 && RATE > 0 && RATE < 200);
+
+public:
+    static constexpr size_t SPONGE_WORDS = 1600 / 8 / sizeof(uint64_t);
+    /// The rate of the sponge in bytes.
+    static constexpr size_t RATE_BYTES = RATE;
+    /// The rate of the sponge in words.
+    static constexpr size_t RATE_WORDS = RATE / sizeof(uint64_t);
+    /// The domain padding byte.
+    static constexpr uint8_t DOMAIN_BYTE = DOMAIN;
+    /// The number of permutation rounds.
+    static constexpr size_t N_ROUNDS = N_R;
+    /// The hash, half the capacity, serialized little-endian from the first lanes of the state.
+    using digest_type = std::array<uint8_t, (200 - RATE) / 2>;
+    /// The version of the serialized context, bumped whenever its layout changes.
+    static constexpr uint8_t SERIAL_VERSION = 1;
+    /// The size of the serialized context: magic, version, rate, domain, rounds, position, pending bytes and state.
+    static constexpr size_t SERIAL_BYTES = 4 + 4 + 8 + 200;
+    /// A serialized context.
+    using serial_type = std::array<std::byte, SERIAL_BYTES>;
+
+protected:
+    /// The portion of the input message that have not been processed yet.
+    uint64_t saved;
+    /// The next byte after the set one.
+    uint32_t byte_index;
+    /// The next word to integrate input.
+    uint32_t word_index;
+    /// The state of the sponge.
+    std::array<uint64_t, Sponge::SPONGE_WORDS> state;
+
+    /**
+     * @brief Pad the absorbed message and apply the final permutation.
+     * @param domain The domain padding byte, e.g. 0x06 for SHA3 or 0x1f for SHAKE.
+     */
+    constexpr void pad(uint8_t domain);
+
+    /**
+     * @brief Serialize the hash out of a state.
+     * @param state The first word of the state.
+     * @param stride The distance between two words of the state.
+     * @param digest The hash.
+     */
+    constexpr static void store_digest(const uint64_t *state, size_t stride, uint8_t *digest);
+
+    /**
+     * @brief Serialize the context along with a padding byte, for variants choosing it at runtime.
+     * @param domain The domain padding byte to record.
+     * @return The serialized context.
+     */
+    constexpr auto serialize(uint8_t domain) const -> serial_type;
+
+    /**
+     * @brief Load a serialized context into this sponge, leaving it untouched if the context is malformed.
+     * @param data The serialized context.
+     * @param domain The recorded domain padding byte.
+     * @return Whether the context has been loaded.
+     */
+    constexpr auto deserialize(std::span<const std::byte> data, uint8_t &domain) -> bool;
+
+public:
+    /**
+     * @brief Initialize or reset a sponge.
+     */
+    constexpr Sponge();
+
+    /**
+     * @brief Update the state of the sponge with the input message.
+     * @param buf_in The input message.
+     * @param length The length of the input message.
+     */
+    constexpr void update(const void *buf_in, size_t length);
+
+    /**
+     * @brief Update the state of the sponge with the input message, also in constant evaluation.
+     * @param data The input message.
+     */
+    constexpr void update(std::span<const std::byte> data);
+
+    /**
+     * @brief Update the state of the sponge with the input text, also in constant evaluation.
+     * @param text The input text, without any terminating null.
+     */
+    constexpr void update(std::string_view text);
+
+    /**
+     * @brief Update the state of the sponge with a message scattered over several fragments, absorbed as one stream.
+     *
+     * A cursor runs across the fragments: a word straddling a boundary is built from the bytes on each side, and
+     * every whole block goes to the bulk absorb, in place inside a fragment or gathered when it spans several. The
+     * call counts as a single update.
+     * @param fragments The fragments of the input message, in order.
+     */
+    constexpr void update(std::span<const std::span<const std::byte>> fragments);
+
+    /**
+     * @brief Finalize the sponge and return the state.
+     * @return The state, whose first bytes are the hash.
+     */
+    constexpr auto finalize() -> std::array<uint64_t, Sponge::SPONGE_WORDS>;
+
+    /**
+     * @brief Finalize the sponge and write only the hash into caller memory.
+     * @param out The hash.
+     */
+    void finalize_into(std::span<std::byte, std::tuple_size_v<digest_type>> out);
+
+    /**
+     * @brief Finalize the sponge and return only the hash.
+     * @return The hash.
+     */
+    constexpr auto digest() -> digest_type;
+
+    /**
+     * @brief Serialize the whole context, so that another process may resume absorbing where this one stopped.
+     *
+     * The layout is versioned and independent of the host byte order; it records the rate, padding and rounds, so
+     * that a context is never resumed by another variant.
+     * @return The serialized context.
+     */
+    constexpr auto serialize() const -> serial_type;
+
+    /**
+     * @brief Resume a serialized context.
+     * @param data The serialized context.
+     * @return The sponge, or nothing if the context is malformed, of another version or of another variant.
+     */
+    constexpr static auto deserialize(std::span<const std::byte> data) -> std::optional<Sponge>;
+
+public:
+    /**
+     * @brief Single-shot hash function returning only the hash.
+     * @param buf_in The input message.
+     * @param length The length of the input message.
+     * @return The hash.
+     */
+    constexpr static auto hash_digest(const void *buf_in, size_t length) -> digest_type;
+
+    /**
+     * @brief Single-shot hash function returning only the hash, also in constant evaluation.
+     * @param data The input message.
+     * @return The hash.
+     */
+    constexpr static auto hash_digest(std::span<const std::byte> data) -> digest_type;
+
+    /**
+     * @brief Single-shot hash function returning only the hash, also in constant evaluation.
+     * @param text The input text, without any terminating null.
+     * @return The hash.
+     */
+    constexpr static auto hash_digest(std::string_view text) -> digest_type;
+
+    /**
+     * @brief Single-shot hash of a message scattered over several fragments.
+     * @param fragments The fragments of the input message, in order.
+     * @return The hash.
+     */
+    constexpr static auto hash_digest(std::span<const std::span<const std::byte>> fragments) -> digest_type;
+
+    /**
+     * @brief Single-shot hash of a message shorter than the rate whose length is known at compile time.
+     *
+     * The message is loaded straight into the lanes of a fresh state and padded at fixed positions, so the call is
+     * little more than one permutation.
+     * @tparam N The length of the input message, less than the rate.
+     * @param buf_in The input message.
+     * @return The hash.
+     */
+    template<size_t N>
+    static auto hash_fixed(const void *buf_in) -> digest_type;
+
+    /**
+     * @brief Single-shot hash of a message shorter than the rate, also in constant evaluation.
+     * @tparam N The length of the input message, less than the rate.
+     * @param data The input message.
+     * @return The hash.
+     */
+    template<size_t N>
+    constexpr static auto hash_fixed(std::span<const std::byte, N> data) -> digest_type;
+
+    /**
+     * @brief Hash many independent messages, running several of them at once with the multi-buffer permutation.
+     *
+     * Messages are grouped by length; whatever does not fit a full group of SIMD lanes is hashed with the scalar
+     * permutation.
+     * @param buffers The input messages.
+     * @param digests The hashes, one per input message.
+     * @throws std::invalid_argument If there are not as many hashes as input messages.
+     */
+    static void hash_many(std::span<const std::span<const uint8_t>> buffers, std::span<digest_type> digests);
+
+private:
+    /**
+     * @brief Absorb the input message; the byte type is kept so that constant evaluation needs no pointer cast.
+     * @tparam Byte The byte type, `uint8_t`, `char` or `std::byte`.
+     * @param buffer The input message.
+     * @param length The length of the input message.
+     */
+    template<typename Byte>
+    constexpr void absorb(const Byte *buffer, size_t length);
+
+    /**
+     * @brief Hash a message of a fixed length shorter than the rate with a single permutation.
+     * @tparam N The length of the input message.
+     * @tparam Byte The byte type, `uint8_t` or `std::byte`.
+     * @param buffer The input message.
+     * @return The hash.
+     */
+    template<size_t N, typename Byte>
+    constexpr static auto absorb_fixed(const Byte *buffer) -> digest_type;
+
+    /**
+     * @brief XOR one rate-sized block of a padded message into a state.
+     * @param state The first word of the state.
+     * @param stride The distance between two words of the state.
+     * @param message The whole message.
+     * @param block The index of the block, the last one being the padded tail.
+     */
+    static void absorb_block(uint64_t *state, size_t stride, std::span<const uint8_t> message, size_t block);
+};
+
+template<size_t BIT, size_t N_R = core::ROUNDS>
+using SHA3Sponge = Sponge<200 - BIT / 4, 0x06, N_R>;
+template<size_t BIT, size_t N_R = core::ROUNDS>
+using KeccakSponge = Sponge<200 - BIT / 4, 0x01, N_R>;
+
+using Keccak256 = KeccakSponge<256>;
+using Keccak384 = KeccakSponge<384>;
+using Keccak512 = KeccakSponge<512>;
+
+/**
+ * @brief Hash a string literal at compile time, e.g. the signatures behind selector and topic tables.
+ * @tparam SPONGE The sponge, Keccak-256 by default.
+ * @param text The text, without any terminating null.
+ * @return The hash.
+ */
+template<typename SPONGE = Keccak256>
+consteval auto literal_digest(std::string_view text) -> typename SPONGE::digest_type {
+    return SPONGE::hash_digest(text);
+}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+constexpr Sponge<RATE, DOMAIN, N_R>::Sponge() : saved{0}, byte_index{0}, word_index{0}, state{} {}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+constexpr void Sponge<RATE, DOMAIN, N_R>::update(const void *buf_in, size_t length) {
+    this->absorb(static_cast<const uint8_t *>(buf_in), length);
+}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+constexpr void Sponge<RATE, DOMAIN, N_R>::update(std::span<const std::byte> data) {
+    this->absorb(data.data(), data.size());
+}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+constexpr void Sponge<RATE, DOMAIN, N_R>::update(std::string_view text) {
+    this->absorb(text.data(), text.size());
+}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+constexpr void Sponge<RATE, DOMAIN, N_R>::update(std::span<const std::span<const std::byte>> fragments) {
+    size_t length = 0;
+    for (const auto fragment: fragments) length += fragment.size();
+    instrumentation::count_update(length, this->byte_index != 0 || length % 8 != 0);
+
+    // The cursor: the unread part of the current fragment, and the index of the next one.
+    std::span<const std::byte> rest;
+    size_t next = 0;
+    const auto skip = [&](size_t n) {
+        rest = rest.subspan(n);
+        while (rest.empty() && next < fragments.size()) rest = fragments[next++];
+    };
+    const auto take_byte = [&] {
+        const auto byte = static_cast<uint64_t>(rest[0]);
+        skip(1);
+        return byte;
+    };
+    const auto add_word = [this](uint64_t word) {
+        this->state[this->word_index] ^= word;
+        if (++this->word_index == Sponge::RATE_WORDS) {
+            core::permute<N_R>(this->state);
+            this->word_index = 0;
+        }
+    };
+    skip(0);
+
+    assert(this->byte_index < 8);
+    assert(this->word_index < Sponge::RATE_WORDS);
+
+    // Complete the pending partial word.
+    if (this->byte_index != 0) {
+        for (; this->byte_index < 8 && length > 0; --length) this->saved |= take_byte() << ((this->byte_index++) * 8);
+        if (this->byte_index < 8) return;
+        add_word(this->saved);
+        this->byte_index = 0;
+        this->saved = 0;
+    }
+
+    while (length >= sizeof(uint64_t)) {
+        if (this->word_index == 0 && length >= RATE) {
+            if (rest.size() >= RATE) {
+                // The whole blocks inside the fragment are absorbed in bulk where they are.
+                const size_t blocks = rest.size() / RATE;
+                core::absorb<N_R>(this->state, rest.data(), blocks, Sponge::RATE_WORDS);
+                skip(blocks * RATE);
+                length -= blocks * RATE;
+            } else {
+                // A block spanning fragments is gathered first, so that it still goes to the bulk absorb.
+                std::array<std::byte, RATE> block{};
+                for (size_t filled = 0; filled < RATE;) {
+                    const size_t n = std::min(rest.size(), RATE - filled);
+                    std::copy_n(rest.data(), n, block.data() + filled);
+                    filled += n;
+                    skip(n);
+                }
+                core::absorb<N_R>(this->state, block.data(), 1, Sponge::RATE_WORDS);
+                length -= RATE;
+            }
+            continue;
+        }
+
+        // Finish the block in progress, or absorb the last words, one lane at a time.
+        if (rest.size() >= sizeof(uint64_t)) {
+            add_word(core::load_le64(rest.data()));
+            skip(sizeof(uint64_t));
+        } else {
+            // The lane straddles a boundary: it is built from the bytes on each side.
+            uint64_t word = 0;
+            for (size_t i = 0; i < sizeof(uint64_t); ++i) word |= take_byte() << (i * 8);
+            add_word(word);
+        }
+        length -= sizeof(uint64_t);
+    }
+
+    assert(this->byte_index == 0 && length < 8);
+    for (; length > 0; --length) this->saved |= take_byte() << ((this->byte_index++) * 8);
+}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+template<typename Byte>
+constexpr void Sponge<RATE, DOMAIN, N_R>::absorb(const Byte *buffer, size_t length) {
+    uint32_t old_tail = (8 - this->byte_index) & 7;
+    instrumentation::count_update(length, old_tail != 0 || length % 8 != 0);
+
+    size_t words;
+    uint32_t tail;
+
+    assert(this->byte_index < 8);
+    assert(this->word_index < Sponge::RATE_WORDS);
+
+    if (length < old_tail) {
+        while (length--) this->saved |= static_cast<uint64_t>(static_cast<uint8_t>(*buffer++)) << ((this->byte_index++) * 8);
+        assert(this->byte_index < 8);
+        return;
+    }
+
+    if (old_tail) {
+        length -= old_tail;
+        while (old_tail--) this->saved |= static_cast<uint64_t>(static_cast<uint8_t>(*buffer++)) << ((this->byte_index++) * 8);
+        this->state[this->word_index] ^= this->saved;
+        assert(this->byte_index == 8);
+        this->byte_index = 0;
+        this->saved = 0;
+        if (++this->word_index == Sponge::RATE_WORDS) {
+            core::permute<N_R>(this->state);
+            this->word_index = 0;
+        }
+    }
+    assert(this->byte_index == 0);
+
+    words = length / sizeof(uint64_t);
+    tail = length - words * sizeof(uint64_t);
+
+    // Finish the block in progress word by word.
+    for (; words > 0 && this->word_index != 0; --words, buffer += sizeof(uint64_t)) {
+        this->state[this->word_index] ^= core::load_le64(buffer);
+        if (++this->word_index == Sponge::RATE_WORDS) {
+            core::permute<N_R>(this->state);
+            this->word_index = 0;
+        }
+    }
+
+    // Absorb the whole blocks in bulk.
+    if (words >= Sponge::RATE_WORDS) {
+        const size_t blocks = words / Sponge::RATE_WORDS;
+        core::absorb<N_R>(this->state, buffer, blocks, Sponge::RATE_WORDS);
+        buffer += blocks * RATE;
+        words -= blocks * Sponge::RATE_WORDS;
+    }
+
+    // The remaining words never reach the end of the block.
+    for (; words > 0; --words, buffer += sizeof(uint64_t)) {
+        this->state[this->word_index++] ^= core::load_le64(buffer);
+    }
+
+    assert(this->byte_index == 0 && tail < 8);
+    while (tail--) {
+        this->saved |= static_cast<uint64_t>(static_cast<uint8_t>(*buffer++)) << ((this->byte_index++) * 8);
+    }
+    assert(this->byte_index < 8);
+}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+constexpr void Sponge<RATE, DOMAIN, N_R>::pad(uint8_t domain) {
+    const uint64_t t = static_cast<uint64_t>(domain) << (this->byte_index * 8);
+    this->state[this->word_index] ^= this->saved ^ t;
+    this->state[Sponge::RATE_WORDS - 1] ^= 0x8000000000000000ULL;
+    core::permute<N_R>(this->state);
+}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+constexpr std::array<uint64_t, Sponge<RATE, DOMAIN, N_R>::SPONGE_WORDS> Sponge<RATE, DOMAIN, N_R>::finalize() {
+    this->pad(DOMAIN);
+    return this->state;
+}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+void Sponge<RATE, DOMAIN, N_R>::finalize_into(std::span<std::byte, std::tuple_size_v<digest_type>> out) {
+    this->pad(DOMAIN);
+    Sponge::store_digest(this->state.data(), 1, reinterpret_cast<uint8_t *>(out.data()));
+}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+constexpr auto Sponge<RATE, DOMAIN, N_R>::digest() -> digest_type {
+    digest_type out{};
+    this->pad(DOMAIN);
+    Sponge::store_digest(this->state.data(), 1, out.data());
+    return out;
+}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+constexpr auto Sponge<RATE, DOMAIN, N_R>::serialize(uint8_t domain) const -> serial_type {
+    serial_type out{};
+    const auto store = [&out](size_t offset, uint64_t x) {
+        for (size_t i = 0; i < sizeof(uint64_t); ++i) out[offset + i] = static_cast<std::byte>(x >> (8 * i));
+    };
+
+    out[0] = std::byte{'K'};
+    out[1] = std::byte{'S'};
+    out[2] = std::byte{'P'};
+    out[3] = std::byte{Sponge::SERIAL_VERSION};
+    out[4] = static_cast<std::byte>(Sponge::RATE_WORDS);
+    out[5] = static_cast<std::byte>(domain);
+    out[6] = static_cast<std::byte>(N_R);
+    out[7] = static_cast<std::byte>(this->word_index * sizeof(uint64_t) + this->byte_index);
+    store(8, this->saved);
+    for (size_t i = 0; i < Sponge::SPONGE_WORDS; ++i) store(16 + i * sizeof(uint64_t), this->state[i]);
+    return out;
+}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+constexpr auto Sponge<RATE, DOMAIN, N_R>::deserialize(std::span<const std::byte> data, uint8_t &domain) -> bool {
+    if (data.size() != Sponge::SERIAL_BYTES) return false;
+    if (data[0] != std::byte{'K'} || data[1] != std::byte{'S'} || data[2] != std::byte{'P'}) return false;
+    if (data[3] != std::byte{Sponge::SERIAL_VERSION}) return false;
+    if (static_cast<size_t>(data[4]) != Sponge::RATE_WORDS || static_cast<size_t>(data[6]) != N_R) return false;
+
+    const auto position = static_cast<uint32_t>(data[7]);
+    if (position >= RATE) return false;
+    const uint64_t saved = core::load_le64(data.data() + 8);
+    // Only the bytes before the position may be pending.
+    const uint32_t byte_index = position % sizeof(uint64_t);
+    if (byte_index == 0 ? saved != 0 : saved >> (8 * byte_index) != 0) return false;
+
+    domain = static_cast<uint8_t>(data[5]);
+    this->saved = saved;
+    this->byte_index = byte_index;
+    this->word_index = position / sizeof(uint64_t);
+    for (size_t i = 0; i < Sponge::SPONGE_WORDS; ++i) {
+        this->state[i] = core::load_le64(data.data() + 16 + i * sizeof(uint64_t));
+    }
+    return true;
+}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+constexpr auto Sponge<RATE, DOMAIN, N_R>::serialize() const -> serial_type {
+    return this->serialize(DOMAIN);
+}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+constexpr auto Sponge<RATE, DOMAIN, N_R>::deserialize(std::span<const std::byte> data) -> std::optional<Sponge> {
+    Sponge sponge;
+    uint8_t domain = 0;
+    if (!sponge.deserialize(data, domain) || domain != DOMAIN) return std::nullopt;
+    return sponge;
+}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+constexpr auto Sponge<RATE, DOMAIN, N_R>::hash_digest(const void *buf_in, size_t length) -> digest_type {
+    Sponge sponge;
+    sponge.update(buf_in, length);
+    return sponge.digest();
+}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+constexpr auto Sponge<RATE, DOMAIN, N_R>::hash_digest(std::span<const std::byte> data) -> digest_type {
+    Sponge sponge;
+    sponge.update(data);
+    return sponge.digest();
+}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+constexpr auto Sponge<RATE, DOMAIN, N_R>::hash_digest(std::string_view text) -> digest_type {
+    Sponge sponge;
+    sponge.update(text);
+    return sponge.digest();
+}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+constexpr auto Sponge<RATE, DOMAIN, N_R>::hash_digest(std::span<const std::span<const std::byte>> fragments)
+        -> digest_type {
+    Sponge sponge;
+    sponge.update(fragments);
+    return sponge.digest();
+}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+template<size_t N>
+auto Sponge<RATE, DOMAIN, N_R>::hash_fixed(const void *buf_in) -> digest_type {
+    return Sponge::absorb_fixed<N>(static_cast<const uint8_t *>(buf_in));
+}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+template<size_t N>
+constexpr auto Sponge<RATE, DOMAIN, N_R>::hash_fixed(std::span<const std::byte, N> data) -> digest_type {
+    return Sponge::absorb_fixed<N>(data.data());
+}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+template<size_t N, typename Byte>
+constexpr auto Sponge<RATE, DOMAIN, N_R>::absorb_fixed(const Byte *buffer) -> digest_type {
+    static_assert(N < RATE, "the message and its padding must fit one block");
+    constexpr size_t WORDS = N / sizeof(uint64_t);
+    constexpr size_t TAIL = N % sizeof(uint64_t);
+    instrumentation::count_update(N, false);
+
+    std::array<uint64_t, Sponge::SPONGE_WORDS> state{};
+    for (size_t i = 0; i < WORDS; ++i) state[i] = core::load_le64(buffer + i * sizeof(uint64_t));
+
+    // The padding byte follows the message in the word holding its tail; the final bit closes the block.
+    uint64_t last = static_cast<uint64_t>(DOMAIN) << (TAIL * 8);
+    for (size_t i = 0; i < TAIL; ++i) {
+        last |= static_cast<uint64_t>(static_cast<uint8_t>(buffer[WORDS * sizeof(uint64_t) + i])) << (i * 8);
+    }
+    state[WORDS] = last;
+    state[Sponge::RATE_WORDS - 1] ^= 0x8000000000000000ULL;
+    core::permute<N_R>(state);
+
+    digest_type out{};
+    Sponge::store_digest(state.data(), 1, out.data());
+    return out;
+}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+void Sponge<RATE, DOMAIN, N_R>::hash_many(std::span<const std::span<const uint8_t>> buffers,
+                                          std::span<digest_type> digests) {
+    if (buffers.size() != digests.size()) {
+        throw std::invalid_argument("hash_many: one hash is needed per input message");
+    }
+
+    const size_t lanes = core::multi_buffer_lanes();
+
+    // Sorting by length keeps the lanes of a group busy for about the same number of blocks.
+    std::vector<size_t> order(buffers.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return buffers[a].size() < buffers[b].size();
+    });
+
+    size_t next = 0;
+    if (lanes > 1) {
+        std::array<uint64_t, core::P_LEN * core::MAX_LANES> states{};
+        for (; next + lanes <= order.size(); next += lanes) {
+            std::fill(states.begin(), states.end(), 0);
+            const size_t common = buffers[order[next]].size() / RATE + 1;
+            for (size_t block = 0; block < common; ++block) {
+                for (size_t lane = 0; lane < lanes; ++lane) {
+                    Sponge::absorb_block(states.data() + lane, lanes, buffers[order[next + lane]], block);
+                }
+                core::keccak_p_many(states.data(), lanes, N_R);
+            }
+
+            // The longer messages of the group finish on the scalar permutation.
+            for (size_t lane = 0; lane < lanes; ++lane) {
+                const auto &message = buffers[order[next + lane]];
+                const size_t blocks = message.size() / RATE + 1;
+                if (blocks == common) {
+                    Sponge::store_digest(states.data() + lane, lanes, digests[order[next + lane]].data());
+                    continue;
+                }
+                std::array<uint64_t, Sponge::SPONGE_WORDS> state{};
+                for (size_t i = 0; i < Sponge::SPONGE_WORDS; ++i) state[i] = states[i * lanes + lane];
+                for (size_t block = common; block < blocks; ++block) {
+                    Sponge::absorb_block(state.data(), 1, message, block);
+                    core::permute<N_R>(state);
+                }
+                Sponge::store_digest(state.data(), 1, digests[order[next + lane]].data());
+            }
+        }
+    }
+
+    for (; next < order.size(); ++next) {
+        const auto &message = buffers[order[next]];
+        std::array<uint64_t, Sponge::SPONGE_WORDS> state{};
+        for (size_t block = 0; block < message.size() / RATE + 1; ++block) {
+            Sponge::absorb_block(state.data(), 1, message, block);
+            core::permute<N_R>(state);
+        }
+        Sponge::store_digest(state.data(), 1, digests[order[next]].data());
+    }
+}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+void Sponge<RATE, DOMAIN, N_R>::absorb_block(uint64_t *state, size_t stride, std::span<const uint8_t> message, size_t block) {
+    const uint8_t *data = message.data() + block * RATE;
+    const size_t remaining = message.size() - block * RATE;
+
+    if (remaining >= RATE) {
+        for (size_t i = 0; i < Sponge::RATE_WORDS; ++i) state[i * stride] ^= core::load_le64(data + i * sizeof(uint64_t));
+        return;
+    }
+
+    std::array<uint8_t, RATE> last{};
+    std::copy_n(data, remaining, last.begin());
+    last[remaining] ^= DOMAIN;
+    last[RATE - 1] ^= 0x80;
+    for (size_t i = 0; i < Sponge::RATE_WORDS; ++i) state[i * stride] ^= core::load_le64(last.data() + i * sizeof(uint64_t));
+}
+
+template<size_t RATE, uint8_t DOMAIN, size_t N_R>
+constexpr void Sponge<RATE, DOMAIN, N_R>::store_digest(const uint64_t *state, size_t stride, uint8_t *digest) {
+    constexpr size_t length = std::tuple_size_v<digest_type>;
+    size_t i = 0;
+    for (; i < length / sizeof(uint64_t); ++i) core::store_le64(digest + i * sizeof(uint64_t), state[i * stride]);
+    // The hash of SHA3-224 ends in the middle of a lane.
+    for (size_t j = i * sizeof(uint64_t); j < length; ++j) digest[j] = static_cast<uint8_t>(state[i * stride] >> (8 * (j % 8)));
+}
+
+} // namespace keccak
+
+#endif //KECCAK_SPONGE_H
@@ -0,0 +1,320 @@
+#ifndef KECCAK_SPONGE_POOL_H
+#define KECCAK_SPONGE_POOL_H
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "keccak.h"
+#include "multi_buffer.h"
+#include "sponge.h"
+
+namespace keccak {
+
+/**
+ * @brief A pool of many live sponge contexts, stored in cache-line-aligned slabs and addressed by index handles.
+ *
+ * Slabs are never moved or freed before the pool, and released contexts are recycled by a cheap reset. Absorbs may
+ * be queued and flushed together: the contexts reaching a block boundary with a whole block ahead are permuted in
+ * the lanes of the multi-buffer permutation. A pool is not thread-safe.
+ * @tparam SPONGE The sponge, e.g. `SHA3Sponge<256>`, `Keccak256` or `SHA3<256>`.
+ */
+template<typename SPONGE>
+class SpongePool {
+public:
+    /// The number of contexts allocated at once.
+    static constexpr size_t SLAB_SIZE = 256;
+
+    using digest_type = typename SPONGE::digest_type;
+
+    /**
+     * @brief The handle of a context; a stale handle is caught by its generation in debug builds.
+     */
+    struct Handle {
+        uint32_t index;
+        uint32_t generation;
+    };
+
+private:
+    /**
+     * @brief One context, starting on its own cache line.
+     */
+    struct alignas(64) Slot : SPONGE {
+        using SPONGE::SPONGE;
+        using SPONGE::saved;
+        using SPONGE::byte_index;
+        using SPONGE::word_index;
+        using SPONGE::state;
+
+        /// Empty the context, keeping whatever runtime padding it was created with.
+        void clear() {
+            this->saved = 0;
+            this->byte_index = 0;
+            this->word_index = 0;
+            this->state = {};
+        }
+    };
+
+    struct Slab {
+        std::array<Slot, SLAB_SIZE> slots;
+    };
+
+    /**
+     * @brief The queued input of one context, as a cursor over its run of pending absorbs.
+     */
+    struct Stream {
+        Slot *slot;
+        /// The pending absorbs of the context, in order.
+        size_t next;
+        size_t end;
+        /// The unread part of the current absorb.
+        std::span<const std::byte> data;
+    };
+
+    std::vector<std::unique_ptr<Slab>> slabs;
+    /// The generation of each context, odd while it is acquired.
+    std::vector<uint32_t> generations;
+    std::vector<uint32_t> free;
+    /// The queued absorbs, by context index.
+    std::vector<std::pair<uint32_t, std::span<const std::byte>>> pending;
+
+public:
+    SpongePool() = default;
+
+    /**
+     * @brief Acquire an empty context, recycling a released one if any.
+     * @param args The constructor arguments of a new context, e.g. the flag of `SHA3<BIT>`.
+     * @return The handle of the context.
+     */
+    template<typename... Args>
+    auto acquire(Args &&...args) -> Handle;
+
+    /**
+     * @brief Release a context for reuse.
+     * @param handle The handle of the context.
+     */
+    void release(Handle handle);
+
+    /**
+     * @brief Empty a context, so that it starts a new message.
+     * @param handle The handle of the context.
+     */
+    void reset(Handle handle);
+
+    /**
+     * @brief Absorb input into a context right away.
+     * @param handle The handle of the context.
+     * @param buf_in The input message.
+     * @param length The length of the input message.
+     */
+    void update(Handle handle, const void *buf_in, size_t length);
+
+    /**
+     * @brief Queue input for a context, absorbed by the next `flush`; the input must stay alive until then.
+     * @param handle The handle of the context.
+     * @param data The input message.
+     */
+    void enqueue(Handle handle, std::span<const std::byte> data);
+
+    /**
+     * @brief Absorb all queued input, permuting the contexts with whole blocks ready in multi-buffer lanes.
+     */
+    void flush();
+
+    /**
+     * @brief Finalize a context and return only its hash; the context must be reset before it is updated again.
+     * @param handle The handle of the context.
+     * @return The hash.
+     */
+    auto digest(Handle handle) -> digest_type;
+
+    /**
+     * @brief Direct access to a context, e.g. to serialize it.
+     * @param handle The handle of the context.
+     * @return The context.
+     */
+    auto operator[](Handle handle) -> SPONGE &;
+
+    /**
+     * @brief The number of acquired contexts.
+     * @return The number of acquired contexts.
+     */
+    auto size() const -> size_t;
+
+private:
+    auto slot(Handle handle) -> Slot &;
+
+    /**
+     * @brief Absorb a stream with the context until it is done, or at a block boundary with a whole block ahead.
+     * @param stream The stream.
+     * @return Whether the stream has a whole block ready.
+     */
+    auto advance(Stream &stream) -> bool;
+
+    /**
+     * @brief Absorb the blocks common to a full group of streams with the multi-buffer permutation.
+     * @param group The streams, as many as the lanes.
+     */
+    static void absorb_lanes(std::span<Stream *const> group);
+};
+
+template<typename SPONGE>
+template<typename... Args>
+auto SpongePool<SPONGE>::acquire(Args &&...args) -> Handle {
+    if (this->free.empty()) {
+        const auto first = static_cast<uint32_t>(this->generations.size());
+        this->slabs.push_back(std::make_unique<Slab>());
+        this->generations.resize(this->generations.size() + SLAB_SIZE, 0);
+        for (size_t i = SLAB_SIZE; i > 0; --i) this->free.push_back(first + static_cast<uint32_t>(i - 1));
+    }
+
+    const uint32_t index = this->free.back();
+    this->free.pop_back();
+    const uint32_t generation = ++this->generations[index];
+    this->slabs[index / SLAB_SIZE]->slots[index % SLAB_SIZE] = Slot(std::forward<Args>(args)...);
+    return {index, generation};
+}
+
+template<typename SPONGE>
+void SpongePool<SPONGE>::release(Handle handle) {
+    this->slot(handle);
+    ++this->generations[handle.index];
+    this->free.push_back(handle.index);
+}
+
+template<typename SPONGE>
+void SpongePool<SPONGE>::reset(Handle handle) {
+    this->slot(handle).clear();
+}
+
+template<typename SPONGE>
+void SpongePool<SPONGE>::update(Handle handle, const void *buf_in, size_t length) {
+    this->slot(handle).update(buf_in, length);
+}
+
+template<typename SPONGE>
+void SpongePool<SPONGE>::enqueue(Handle handle, std::span<const std::byte> data) {
+    this->slot(handle);
+    if (!data.empty()) this->pending.emplace_back(handle.index, data);
+}
+
+template<typename SPONGE>
+void SpongePool<SPONGE>::flush() {
+    // The absorbs of each context stay in order, and the contexts in the order of their slots.
+    std::stable_sort(this->pending.begin(), this->pending.end(),
+                     [](const auto &a, const auto &b) { return a.first < b.first; });
+
+    std::vector<Stream> streams;
+    for (size_t begin = 0, end; begin < this->pending.size(); begin = end) {
+        const uint32_t index = this->pending[begin].first;
+        for (end = begin + 1; end < this->pending.size() && this->pending[end].first == index; ++end);
+        Slot *slot = &this->slabs[index / SLAB_SIZE]->slots[index % SLAB_SIZE];
+        streams.push_back({slot, begin + 1, end, this->pending[begin].second});
+    }
+
+    const size_t lanes = core::multi_buffer_lanes();
+    std::vector<Stream *> ready;
+    for (auto &stream: streams) {
+        if (this->advance(stream)) ready.push_back(&stream);
+    }
+
+    while (!ready.empty()) {
+        size_t first = 0;
+        if (lanes > 1) {
+            for (; first + lanes <= ready.size(); first += lanes) {
+                SpongePool::absorb_lanes(std::span<Stream *const>(ready).subspan(first, lanes));
+            }
+        }
+        // Too few streams for a group: the bulk absorb of the selected kernel.
+        for (size_t i = first; i < ready.size(); ++i) {
+            Stream &stream = *ready[i];
+            const size_t blocks = stream.data.size() / SPONGE::RATE_BYTES;
+            core::absorb<SPONGE::N_ROUNDS>(stream.slot->state, stream.data.data(), blocks, SPONGE::RATE_WORDS);
+            stream.data = stream.data.subspan(blocks * SPONGE::RATE_BYTES);
+        }
+
+        std::erase_if(ready, [this](Stream *stream) { return !this->advance(*stream); });
+    }
+    this->pending.clear();
+}
+
+template<typename SPONGE>
+auto SpongePool<SPONGE>::digest(Handle handle) -> digest_type {
+    return this->slot(handle).digest();
+}
+
+template<typename SPONGE>
+auto SpongePool<SPONGE>::operator[](Handle handle) -> SPONGE & {
+    return this->slot(handle);
+}
+
+template<typename SPONGE>
+auto SpongePool<SPONGE>::size() const -> size_t {
+    return this->generations.size() - this->free.size();
+}
+
+template<typename SPONGE>
+auto SpongePool<SPONGE>::slot(Handle handle) -> Slot & {
+    assert(handle.index < this->generations.size() && this->generations[handle.index] == handle.generation);
+    assert(handle.generation % 2 == 1);
+    return this->slabs[handle.index / SLAB_SIZE]->slots[handle.index % SLAB_SIZE];
+}
+
+template<typename SPONGE>
+auto SpongePool<SPONGE>::advance(Stream &stream) -> bool {
+    for (;;) {
+        Slot &slot = *stream.slot;
+        const size_t position = slot.word_index * sizeof(uint64_t) + slot.byte_index;
+        if (position == 0 && stream.data.size() >= SPONGE::RATE_BYTES) return true;
+
+        // Up to the block boundary, or all of a short absorb.
+        const size_t n = position == 0 ? stream.data.size()
+                                       : std::min(stream.data.size(), SPONGE::RATE_BYTES - position);
+        slot.update(stream.data.first(n));
+        stream.data = stream.data.subspan(n);
+
+        if (stream.data.empty()) {
+            if (stream.next == stream.end) return false;
+            stream.data = this->pending[stream.next++].second;
+        }
+    }
+}
+
+template<typename SPONGE>
+void SpongePool<SPONGE>::absorb_lanes(std::span<Stream *const> group) {
+    const size_t lanes = group.size();
+    std::array<uint64_t, core::P_LEN * core::MAX_LANES> states{};
+
+    size_t blocks = SIZE_MAX;
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        const Stream &stream = *group[lane];
+        blocks = std::min(blocks, stream.data.size() / SPONGE::RATE_BYTES);
+        for (size_t i = 0; i < core::P_LEN; ++i) states[i * lanes + lane] = stream.slot->state[i];
+    }
+
+    for (size_t block = 0; block < blocks; ++block) {
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            const std::byte *data = group[lane]->data.data() + block * SPONGE::RATE_BYTES;
+            for (size_t i = 0; i < SPONGE::RATE_WORDS; ++i) {
+                states[i * lanes + lane] ^= core::load_le64(data + i * sizeof(uint64_t));
+            }
+        }
+        core::keccak_p_many(states.data(), lanes, SPONGE::N_ROUNDS);
+    }
+
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        Stream &stream = *group[lane];
+        for (size_t i = 0; i < core::P_LEN; ++i) stream.slot->state[i] = states[i * lanes + lane];
+        stream.data = stream.data.subspan(blocks * SPONGE::RATE_BYTES);
+    }
+}
+
+} // namespace keccak
+
+#endif //KECCAK_SPONGE_POOL_H
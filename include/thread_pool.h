@@ -0,0 +1,92 @@
+#ifndef KECCAK_THREAD_POOL_H
+#define KECCAK_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace keccak {
+
+/**
+ * @brief A work-stealing thread pool for the parallel hashing modes.
+ *
+ * Every worker owns a task queue. Tasks submitted from a worker go to its own queue, others are spread round-robin,
+ * and an idle worker steals from the other queues before going to sleep.
+ */
+class ThreadPool {
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    /// The task queues, one per worker.
+    std::vector<std::unique_ptr<Queue>> queues;
+    /// The workers.
+    std::vector<std::thread> workers;
+    /// The number of queued tasks.
+    std::atomic<size_t> pending;
+    /// The queue the next outside submission goes to.
+    std::atomic<size_t> next;
+    /// Guards the sleep of idle workers.
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping;
+
+public:
+    /**
+     * @brief Start the workers.
+     * @param workers The number of workers, 0 for one per hardware thread.
+     */
+    explicit ThreadPool(size_t workers = 0);
+
+    /**
+     * @brief Run the remaining tasks and join the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /**
+     * @brief The number of workers.
+     * @return The number of workers.
+     */
+    [[nodiscard]] auto size() const -> size_t;
+
+    /**
+     * @brief Queue a task.
+     * @param task The task.
+     * @return The future result of the task.
+     */
+    template<typename F>
+    auto submit(F &&task) -> std::future<std::invoke_result_t<std::decay_t<F>>>;
+
+private:
+    void push(std::function<void()> task);
+
+    auto pop(size_t index, std::function<void()> &task) -> bool;
+
+    void run(size_t index);
+};
+
+template<typename F>
+auto ThreadPool::submit(F &&task) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+    using R = std::invoke_result_t<std::decay_t<F>>;
+    auto packaged = std::make_shared<std::packaged_task<R()>>(std::forward<F>(task));
+    auto future = packaged->get_future();
+    this->push([packaged] { (*packaged)(); });
+    return future;
+}
+
+} // namespace keccak
+
+#endif //KECCAK_THREAD_POOL_H
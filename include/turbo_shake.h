@@ -0,0 +1,35 @@
+#ifndef KECCAK_TURBO_SHAKE_H
+#define KECCAK_TURBO_SHAKE_H
+
+#include <cassert>
+#include <cstdint>
+
+#include "shake.h"
+
+namespace keccak {
+
+/**
+ * @brief The TurboSHAKE extendable-output function: SHAKE on the 12-round keccak-p[1600, 12].
+ * @tparam BIT The security strength, 128 or 256.
+ */
+template<size_t BIT>
+class TurboSHAKE : public SHAKE<BIT, 12> {
+public:
+    /**
+     * @brief Initialize a TurboSHAKE instance.
+     * @param domain The domain separation byte D, between 0x01 and 0x7f.
+     */
+    constexpr explicit TurboSHAKE(uint8_t domain = 0x1f);
+};
+
+using TurboSHAKE128 = TurboSHAKE<128>;
+using TurboSHAKE256 = TurboSHAKE<256>;
+
+template<size_t BIT>
+constexpr TurboSHAKE<BIT>::TurboSHAKE(uint8_t domain) : SHAKE<BIT, 12>(domain) {
+    assert(domain >= 0x01 && domain <= 0x7f);
+}
+
+} // namespace keccak
+
+#endif //KECCAK_TURBO_SHAKE_H
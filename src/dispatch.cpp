@@ -0,0 +1,98 @@
+#include "dispatch.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "kernels.h"
+#include "multi_buffer.h"
+
+namespace keccak::core {
+namespace {
+
+constexpr Kernels SCALAR_KERNELS{
+        Kernel::SCALAR, "scalar", 1,
+        keccak_p_scalar<ROUNDS>, nullptr, absorb_scalar<ROUNDS>,
+        keccak_p_scalar<12>, nullptr, absorb_scalar<12>,
+};
+
+constexpr Kernels INTERLEAVED_KERNELS{
+        Kernel::INTERLEAVED, "interleaved", 1,
+        keccak_p_bit_interleaved<ROUNDS>, nullptr, absorb_bit_interleaved<ROUNDS>,
+        keccak_p_bit_interleaved<12>, nullptr, absorb_bit_interleaved<12>,
+};
+
+#if defined(KECCAK_X86_KERNELS)
+constexpr Kernels BMI2_KERNELS{
+        Kernel::BMI2, "bmi2", 1,
+        keccak_p_bmi2<ROUNDS>, nullptr, absorb_bmi2<ROUNDS>,
+        keccak_p_bmi2<12>, nullptr, absorb_bmi2<12>,
+};
+constexpr Kernels AVX2_KERNELS{
+        Kernel::AVX2, "avx2", 4,
+        keccak_p_bmi2<ROUNDS>, keccak_p_x4<ROUNDS>, absorb_bmi2<ROUNDS>,
+        keccak_p_bmi2<12>, keccak_p_x4<12>, absorb_bmi2<12>,
+};
+constexpr Kernels AVX512_KERNELS{
+        Kernel::AVX512, "avx512", 8,
+        keccak_p_avx512<ROUNDS>, keccak_p_x8<ROUNDS>, absorb_avx512<ROUNDS>,
+        keccak_p_avx512<12>, keccak_p_x8<12>, absorb_avx512<12>,
+};
+#endif
+
+auto select() -> const Kernels & {
+    // The interleaved kernel stays opt-in, also on 32-bit targets: every single permutation converts the whole state
+    // in and out, and it has not been measured against the scalar kernel there.
+    const Kernels *best = &SCALAR_KERNELS;
+    for (auto kernel: {Kernel::BMI2, Kernel::AVX2, Kernel::AVX512}) {
+        if (const Kernels *candidate = kernels_for(kernel)) best = candidate;
+    }
+
+    if (const char *forced = std::getenv("KECCAK_KERNEL")) {
+        for (auto kernel: {Kernel::SCALAR, Kernel::BMI2, Kernel::AVX2, Kernel::AVX512, Kernel::INTERLEAVED}) {
+            const Kernels *candidate = kernels_for(kernel);
+            if (candidate != nullptr && std::strcmp(candidate->name, forced) == 0) return *candidate;
+        }
+        // A typo, or a kernel the build or the cpu lacks, must not silently test another kernel.
+        std::fprintf(stderr, "keccak: KECCAK_KERNEL=%s is not an available kernel, using %s\n", forced, best->name);
+    }
+    return *best;
+}
+
+} // namespace
+
+auto kernels() -> const Kernels & {
+    static const Kernels &selected = select();
+    return selected;
+}
+
+auto kernels_for(Kernel kernel) -> const Kernels * {
+#if defined(KECCAK_X86_KERNELS)
+    __builtin_cpu_init();
+    const bool bmi2 = __builtin_cpu_supports("bmi") && __builtin_cpu_supports("bmi2");
+    switch (kernel) {
+        case Kernel::SCALAR:
+            return &SCALAR_KERNELS;
+        case Kernel::BMI2:
+            return bmi2 ? &BMI2_KERNELS : nullptr;
+        case Kernel::AVX2:
+            return bmi2 && __builtin_cpu_supports("avx2") ? &AVX2_KERNELS : nullptr;
+        case Kernel::AVX512:
+            return bmi2 && __builtin_cpu_supports("avx512f") ? &AVX512_KERNELS : nullptr;
+        case Kernel::INTERLEAVED:
+            return &INTERLEAVED_KERNELS;
+    }
+    return nullptr;
+#else
+    switch (kernel) {
+        case Kernel::SCALAR:
+            return &SCALAR_KERNELS;
+        case Kernel::INTERLEAVED:
+            return &INTERLEAVED_KERNELS;
+        default:
+            return nullptr;
+    }
+#endif
+}
+
+} // namespace keccak::core
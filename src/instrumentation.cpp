@@ -0,0 +1,91 @@
+#include "instrumentation.h"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace keccak::instrumentation {
+namespace {
+
+void add(Counters &total, const detail::LocalCounters &counters) {
+    total.permutations += counters.permutations.load(std::memory_order_relaxed);
+    total.multi_buffer_calls += counters.multi_buffer_calls.load(std::memory_order_relaxed);
+    total.updates += counters.updates.load(std::memory_order_relaxed);
+    total.bytes_absorbed += counters.bytes_absorbed.load(std::memory_order_relaxed);
+    total.partial_words += counters.partial_words.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < SIZE_BUCKETS; ++i) {
+        total.update_sizes[i] += counters.update_sizes[i].load(std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief The counters of every thread: the blocks of the live ones, and the sum of the exited ones.
+ */
+struct Registry {
+    std::mutex mutex;
+    std::vector<const detail::LocalCounters *> live;
+    Counters retired{};
+    /// The total at the last reset, subtracted by snapshots so that reset never writes another thread's block.
+    Counters baseline{};
+
+    auto total() -> Counters {
+        Counters sum = this->retired;
+        for (const auto *counters: this->live) add(sum, *counters);
+        return sum;
+    }
+};
+
+/// Never destroyed, so that threads exiting after static destruction still find it.
+auto registry() -> Registry & {
+    static auto *registry = new Registry;
+    return *registry;
+}
+
+/**
+ * @brief The block of one thread, folded into the retired sum when the thread exits.
+ */
+struct ThreadCounters {
+    detail::LocalCounters counters{};
+
+    ThreadCounters() {
+        Registry &registry = instrumentation::registry();
+        std::lock_guard lock(registry.mutex);
+        registry.live.push_back(&this->counters);
+    }
+
+    ~ThreadCounters() {
+        Registry &registry = instrumentation::registry();
+        std::lock_guard lock(registry.mutex);
+        add(registry.retired, this->counters);
+        registry.live.erase(std::find(registry.live.begin(), registry.live.end(), &this->counters));
+    }
+};
+
+} // namespace
+
+auto detail::local() -> LocalCounters & {
+    thread_local ThreadCounters counters;
+    return counters.counters;
+}
+
+auto snapshot() -> Counters {
+    Registry &registry = instrumentation::registry();
+    std::lock_guard lock(registry.mutex);
+    Counters counters = registry.total();
+    const Counters &baseline = registry.baseline;
+    counters.permutations -= baseline.permutations;
+    counters.multi_buffer_calls -= baseline.multi_buffer_calls;
+    counters.updates -= baseline.updates;
+    counters.bytes_absorbed -= baseline.bytes_absorbed;
+    counters.partial_words -= baseline.partial_words;
+    for (size_t i = 0; i < SIZE_BUCKETS; ++i) counters.update_sizes[i] -= baseline.update_sizes[i];
+    return counters;
+}
+
+void reset() {
+    Registry &registry = instrumentation::registry();
+    std::lock_guard lock(registry.mutex);
+    registry.baseline = registry.total();
+}
+
+} // namespace keccak::instrumentation
@@ -0,0 +1,158 @@
+#include "kangaroo_twelve.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+#include "multi_buffer.h"
+
+namespace keccak {
+namespace {
+
+/// The rate of TurboSHAKE128 in bytes.
+constexpr size_t RATE = TurboSHAKE128::RATE;
+/// The domain byte of the leaves.
+constexpr uint8_t LEAF_DOMAIN = 0x0b;
+
+/**
+ * @brief Encode `length_encode(x)` of RFC 9861.
+ * @return The length of the encoding.
+ */
+auto length_encode(uint64_t x, uint8_t (&bytes)[9]) -> size_t {
+    size_t n = 0;
+    while (n < 8 && (x >> (8 * n)) != 0) ++n;
+    for (size_t i = 0; i < n; ++i) bytes[i] = static_cast<uint8_t>(x >> (8 * (n - 1 - i)));
+    bytes[n] = static_cast<uint8_t>(n);
+    return n + 1;
+}
+
+/**
+ * @brief Hash `lanes` full chunks at once with the multi-buffer permutation.
+ */
+void hash_chunks_many(const uint8_t *data, size_t lanes, uint8_t *cvs) {
+    constexpr size_t RATE_WORDS = RATE / sizeof(uint64_t);
+    constexpr size_t TAIL = KangarooTwelve::CHUNK % RATE;
+
+    std::array<uint64_t, core::P_LEN * core::MAX_LANES> states{};
+    for (size_t offset = 0; offset + RATE <= KangarooTwelve::CHUNK; offset += RATE) {
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            const uint8_t *block = data + lane * KangarooTwelve::CHUNK + offset;
+            for (size_t i = 0; i < RATE_WORDS; ++i) states[i * lanes + lane] ^= core::load_le64(block + i * sizeof(uint64_t));
+        }
+        core::keccak_p_many(states.data(), lanes, 12);
+    }
+
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        std::array<uint8_t, RATE> last{};
+        std::copy_n(data + lane * KangarooTwelve::CHUNK + KangarooTwelve::CHUNK - TAIL, TAIL, last.begin());
+        last[TAIL] ^= LEAF_DOMAIN;
+        last[RATE - 1] ^= 0x80;
+        for (size_t i = 0; i < RATE_WORDS; ++i) states[i * lanes + lane] ^= core::load_le64(last.data() + i * sizeof(uint64_t));
+    }
+    core::keccak_p_many(states.data(), lanes, 12);
+
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        for (size_t i = 0; i < KangarooTwelve::CV_BYTES / sizeof(uint64_t); ++i) {
+            core::store_le64(cvs + lane * KangarooTwelve::CV_BYTES + i * sizeof(uint64_t), states[i * lanes + lane]);
+        }
+    }
+}
+
+} // namespace
+
+KangarooTwelve::KangarooTwelve(std::string_view customization)
+        : customization{customization}, first{}, leaves{}, chunks{0}, tree{false}, squeezing{false}, node{0x07} {
+    this->first.reserve(KangarooTwelve::CHUNK);
+}
+
+void KangarooTwelve::update(const void *buf_in, size_t length) {
+    assert(!this->squeezing);
+    this->absorb(static_cast<const uint8_t *>(buf_in), length);
+}
+
+void KangarooTwelve::squeeze(void *buf_out, size_t length) {
+    if (!this->squeezing) {
+        // S = M || C || length_encode(|C|)
+        uint8_t encoded[9]{};
+        this->absorb(reinterpret_cast<const uint8_t *>(this->customization.data()), this->customization.size());
+        this->absorb(encoded, length_encode(this->customization.size(), encoded));
+
+        if (!this->tree) {
+            this->node = TurboSHAKE128(0x07);
+            this->node.update(this->first.data(), this->first.size());
+        } else {
+            for (size_t offset = 0; offset < this->leaves.size(); offset += KangarooTwelve::CHUNK) {
+                uint8_t cv[KangarooTwelve::CV_BYTES];
+                TurboSHAKE128 leaf(LEAF_DOMAIN);
+                leaf.update(this->leaves.data() + offset, std::min(KangarooTwelve::CHUNK, this->leaves.size() - offset));
+                leaf.squeeze(cv, sizeof(cv));
+                this->node.update(cv, sizeof(cv));
+                ++this->chunks;
+            }
+            this->node.update(encoded, length_encode(this->chunks, encoded));
+            this->node.update("\xff\xff", 2);
+        }
+        this->squeezing = true;
+    }
+    this->node.squeeze(buf_out, length);
+}
+
+void KangarooTwelve::hash_buffer(const void *buf_in, size_t length, void *buf_out, size_t out_length,
+                                 std::string_view customization) {
+    KangarooTwelve k12(customization);
+    k12.update(buf_in, length);
+    k12.squeeze(buf_out, out_length);
+}
+
+void KangarooTwelve::absorb(const uint8_t *data, size_t length) {
+    const size_t batch = core::multi_buffer_lanes() * KangarooTwelve::CHUNK;
+
+    while (length > 0) {
+        if (!this->tree) {
+            if (this->first.size() < KangarooTwelve::CHUNK) {
+                const size_t n = std::min(length, KangarooTwelve::CHUNK - this->first.size());
+                this->first.insert(this->first.end(), data, data + n);
+                data += n;
+                length -= n;
+                continue;
+            }
+            // More than one chunk: the first one opens the final node.
+            this->tree = true;
+            this->node = TurboSHAKE128(0x06);
+            this->node.update(this->first.data(), this->first.size());
+            this->node.update("\x03\x00\x00\x00\x00\x00\x00\x00", 8);
+            this->leaves.reserve(batch);
+        }
+
+        // Whole batches straight from the input, the rest through the leaf buffer.
+        if (this->leaves.empty() && length >= batch) {
+            this->hash_leaves(data, batch / KangarooTwelve::CHUNK);
+            data += batch;
+            length -= batch;
+            continue;
+        }
+        const size_t n = std::min(length, batch - this->leaves.size());
+        this->leaves.insert(this->leaves.end(), data, data + n);
+        data += n;
+        length -= n;
+        if (this->leaves.size() == batch) {
+            this->hash_leaves(this->leaves.data(), batch / KangarooTwelve::CHUNK);
+            this->leaves.clear();
+        }
+    }
+}
+
+void KangarooTwelve::hash_leaves(const uint8_t *data, size_t count) {
+    std::array<uint8_t, KangarooTwelve::CV_BYTES * core::MAX_LANES> cvs{};
+    if (count > 1) {
+        hash_chunks_many(data, count, cvs.data());
+    } else {
+        TurboSHAKE128 leaf(LEAF_DOMAIN);
+        leaf.update(data, KangarooTwelve::CHUNK);
+        leaf.squeeze(cvs.data(), KangarooTwelve::CV_BYTES);
+    }
+    this->node.update(cvs.data(), count * KangarooTwelve::CV_BYTES);
+    this->chunks += count;
+}
+
+} // namespace keccak
@@ -0,0 +1,119 @@
+#ifndef KECCAK_KECCAK_SIMD_H
+#define KECCAK_KECCAK_SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "keccak.h"
+
+/**
+ * @brief The keccak rounds written against a SIMD vector type, shared by the multi-buffer kernels.
+ *
+ * `Ops` provides `V`, `load`, `store`, `xor5` (five-way XOR), `chi` (`a ^ (~b & c)`), `rotl` and `broadcast`.
+ * Each kernel translation unit instantiates it under its own target flags, so everything stays internal.
+ */
+namespace keccak::core::simd {
+namespace {
+
+template<typename Ops, int N>
+KECCAK_FORCE_INLINE auto rotl(typename Ops::V x) -> typename Ops::V {
+    return Ops::template rotl<N>(x);
+}
+
+template<typename Ops>
+KECCAK_FORCE_INLINE void round(const typename Ops::V (&a)[P_LEN], typename Ops::V (&e)[P_LEN], uint64_t rc) {
+    using V = typename Ops::V;
+
+    const V ca = Ops::xor5(a[0], a[5], a[10], a[15], a[20]);
+    const V ce = Ops::xor5(a[1], a[6], a[11], a[16], a[21]);
+    const V ci = Ops::xor5(a[2], a[7], a[12], a[17], a[22]);
+    const V co = Ops::xor5(a[3], a[8], a[13], a[18], a[23]);
+    const V cu = Ops::xor5(a[4], a[9], a[14], a[19], a[24]);
+
+    const V da = Ops::xor2(cu, rotl<Ops, 1>(ce));
+    const V de = Ops::xor2(ca, rotl<Ops, 1>(ci));
+    const V di = Ops::xor2(ce, rotl<Ops, 1>(co));
+    const V do_ = Ops::xor2(ci, rotl<Ops, 1>(cu));
+    const V du = Ops::xor2(co, rotl<Ops, 1>(ca));
+
+    V ba, be, bi, bo, bu;
+
+    ba = Ops::xor2(a[0], da);
+    be = rotl<Ops, 44>(Ops::xor2(a[6], de));
+    bi = rotl<Ops, 43>(Ops::xor2(a[12], di));
+    bo = rotl<Ops, 21>(Ops::xor2(a[18], do_));
+    bu = rotl<Ops, 14>(Ops::xor2(a[24], du));
+    e[0] = Ops::xor2(Ops::chi(ba, be, bi), Ops::broadcast(rc));
+    e[1] = Ops::chi(be, bi, bo);
+    e[2] = Ops::chi(bi, bo, bu);
+    e[3] = Ops::chi(bo, bu, ba);
+    e[4] = Ops::chi(bu, ba, be);
+
+    ba = rotl<Ops, 28>(Ops::xor2(a[3], do_));
+    be = rotl<Ops, 20>(Ops::xor2(a[9], du));
+    bi = rotl<Ops, 3>(Ops::xor2(a[10], da));
+    bo = rotl<Ops, 45>(Ops::xor2(a[16], de));
+    bu = rotl<Ops, 61>(Ops::xor2(a[22], di));
+    e[5] = Ops::chi(ba, be, bi);
+    e[6] = Ops::chi(be, bi, bo);
+    e[7] = Ops::chi(bi, bo, bu);
+    e[8] = Ops::chi(bo, bu, ba);
+    e[9] = Ops::chi(bu, ba, be);
+
+    ba = rotl<Ops, 1>(Ops::xor2(a[1], de));
+    be = rotl<Ops, 6>(Ops::xor2(a[7], di));
+    bi = rotl<Ops, 25>(Ops::xor2(a[13], do_));
+    bo = rotl<Ops, 8>(Ops::xor2(a[19], du));
+    bu = rotl<Ops, 18>(Ops::xor2(a[20], da));
+    e[10] = Ops::chi(ba, be, bi);
+    e[11] = Ops::chi(be, bi, bo);
+    e[12] = Ops::chi(bi, bo, bu);
+    e[13] = Ops::chi(bo, bu, ba);
+    e[14] = Ops::chi(bu, ba, be);
+
+    ba = rotl<Ops, 27>(Ops::xor2(a[4], du));
+    be = rotl<Ops, 36>(Ops::xor2(a[5], da));
+    bi = rotl<Ops, 10>(Ops::xor2(a[11], de));
+    bo = rotl<Ops, 15>(Ops::xor2(a[17], di));
+    bu = rotl<Ops, 56>(Ops::xor2(a[23], do_));
+    e[15] = Ops::chi(ba, be, bi);
+    e[16] = Ops::chi(be, bi, bo);
+    e[17] = Ops::chi(bi, bo, bu);
+    e[18] = Ops::chi(bo, bu, ba);
+    e[19] = Ops::chi(bu, ba, be);
+
+    ba = rotl<Ops, 62>(Ops::xor2(a[2], di));
+    be = rotl<Ops, 55>(Ops::xor2(a[8], do_));
+    bi = rotl<Ops, 39>(Ops::xor2(a[14], du));
+    bo = rotl<Ops, 41>(Ops::xor2(a[15], da));
+    bu = rotl<Ops, 2>(Ops::xor2(a[21], de));
+    e[20] = Ops::chi(ba, be, bi);
+    e[21] = Ops::chi(be, bi, bo);
+    e[22] = Ops::chi(bi, bo, bu);
+    e[23] = Ops::chi(bo, bu, ba);
+    e[24] = Ops::chi(bu, ba, be);
+}
+
+/**
+ * @brief Apply the keccak-p[1600, n_r] permutation to `Ops::LANES` interleaved states.
+ * @tparam N_R The number of rounds, even.
+ * @param states The interleaved states, `P_LEN * Ops::LANES` words.
+ */
+template<typename Ops, size_t N_R>
+KECCAK_FORCE_INLINE void keccak_p(uint64_t *states) {
+    static_assert(N_R <= ROUNDS && N_R % 2 == 0);
+    typename Ops::V a[P_LEN], e[P_LEN];
+
+    for (size_t i = 0; i < P_LEN; ++i) a[i] = Ops::load(states + i * Ops::LANES);
+    for (size_t i = ROUNDS - N_R; i < ROUNDS; i += 2) {
+        round<Ops>(a, e, round_constants[i]);
+        round<Ops>(e, a, round_constants[i + 1]);
+    }
+    for (size_t i = 0; i < P_LEN; ++i) Ops::store(states + i * Ops::LANES, a[i]);
+}
+
+} // namespace
+} // namespace keccak::core::simd
+
+#endif //KECCAK_KECCAK_SIMD_H
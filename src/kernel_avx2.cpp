@@ -0,0 +1,46 @@
+#include "multi_buffer.h"
+
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+#include "keccak_simd.h"
+
+namespace keccak::core {
+namespace {
+
+struct Avx2 {
+    using V = __m256i;
+    static constexpr size_t LANES = 4;
+
+    static V load(const uint64_t *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+
+    static void store(uint64_t *p, V x) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), x); }
+
+    static V broadcast(uint64_t x) { return _mm256_set1_epi64x(static_cast<long long>(x)); }
+
+    static V xor2(V a, V b) { return _mm256_xor_si256(a, b); }
+
+    static V xor5(V a, V b, V c, V d, V e) {
+        return _mm256_xor_si256(_mm256_xor_si256(_mm256_xor_si256(a, b), _mm256_xor_si256(c, d)), e);
+    }
+
+    static V chi(V a, V b, V c) { return _mm256_xor_si256(a, _mm256_andnot_si256(b, c)); }
+
+    template<int N>
+    static V rotl(V x) { return _mm256_or_si256(_mm256_slli_epi64(x, N), _mm256_srli_epi64(x, 64 - N)); }
+};
+
+} // namespace
+
+template<size_t N_R>
+void keccak_p_x4(uint64_t *states) {
+    simd::keccak_p<Avx2, N_R>(states);
+}
+
+template void keccak_p_x4<ROUNDS>(uint64_t *states);
+template void keccak_p_x4<12>(uint64_t *states);
+
+} // namespace keccak::core
+
+#endif
@@ -0,0 +1,160 @@
+#include "kernels.h"
+#include "multi_buffer.h"
+
+#if defined(__AVX512F__)
+
+#include <algorithm>
+#include <immintrin.h>
+
+#include "keccak_simd.h"
+
+namespace keccak::core {
+namespace {
+
+struct Avx512 {
+    using V = __m512i;
+    static constexpr size_t LANES = 8;
+
+    static V load(const uint64_t *p) { return _mm512_loadu_si512(p); }
+
+    static void store(uint64_t *p, V x) { _mm512_storeu_si512(p, x); }
+
+    static V broadcast(uint64_t x) { return _mm512_set1_epi64(static_cast<long long>(x)); }
+
+    static V xor2(V a, V b) { return _mm512_xor_si512(a, b); }
+
+    static V xor5(V a, V b, V c, V d, V e) {
+        return _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64(a, b, c, 0x96), d, e, 0x96);
+    }
+
+    static V chi(V a, V b, V c) { return _mm512_ternarylogic_epi64(a, b, c, 0xd2); }
+
+    template<int N>
+    static V rotl(V x) { return _mm512_rol_epi64(x, N); }
+};
+
+/**
+ * @brief One state in five registers, row y of the 5x5 lane matrix in lanes 0-4 of `row[y]`.
+ *
+ * Lanes 5-7 carry junk that no permute ever moves back into lanes 0-4.
+ */
+struct Rows {
+    __m512i row[5];
+};
+
+/// Keep only the five lanes of a row.
+constexpr __mmask8 ROW = 0x1f;
+
+KECCAK_FORCE_INLINE void round(Rows &a, uint64_t rc) {
+    // Lane x of a row gets lane x - 1, x + 1 or x + 2 of the same row.
+    const __m512i prev = _mm512_setr_epi64(4, 0, 1, 2, 3, 5, 6, 7);
+    const __m512i next = _mm512_setr_epi64(1, 2, 3, 4, 0, 5, 6, 7);
+    const __m512i next2 = _mm512_setr_epi64(2, 3, 4, 0, 1, 5, 6, 7);
+
+    // Theta: the column parities in one register, then D[x] = C[x - 1] ^ rotl(C[x + 1], 1) folded into each row.
+    const __m512i c = _mm512_ternarylogic_epi64(
+            _mm512_ternarylogic_epi64(a.row[0], a.row[1], a.row[2], 0x96), a.row[3], a.row[4], 0x96);
+    const __m512i c_prev = _mm512_permutexvar_epi64(prev, c);
+    const __m512i c_next = _mm512_rol_epi64(_mm512_permutexvar_epi64(next, c), 1);
+
+    // Rho: every lane has its own rotation.
+    const __m512i rho[5] = {
+            _mm512_setr_epi64(0, 1, 62, 28, 27, 0, 0, 0),
+            _mm512_setr_epi64(36, 44, 6, 55, 20, 0, 0, 0),
+            _mm512_setr_epi64(3, 10, 43, 25, 39, 0, 0, 0),
+            _mm512_setr_epi64(41, 45, 15, 21, 8, 0, 0, 0),
+            _mm512_setr_epi64(18, 2, 61, 56, 14, 0, 0, 0),
+    };
+    __m512i b[5];
+    for (size_t y = 0; y < 5; ++y) {
+        b[y] = _mm512_rolv_epi64(_mm512_ternarylogic_epi64(a.row[y], c_prev, c_next, 0x96), rho[y]);
+    }
+
+    // Pi: lane x of output row y is lane (x + 3y) % 5 of input row x, a transpose of rows with the column
+    // order folded into the permutes. Rows 0 and 1, and rows 2 and 3, are first paired for output rows 0-3.
+    const __m512i b01 = _mm512_permutex2var_epi64(b[0], _mm512_setr_epi64(0, 9, 3, 12, 1, 10, 4, 8), b[1]);
+    const __m512i b23 = _mm512_permutex2var_epi64(b[2], _mm512_setr_epi64(2, 11, 0, 9, 3, 12, 1, 10), b[3]);
+    const __m512i pair[4] = {
+            _mm512_setr_epi64(0, 1, 8, 9, 0, 0, 0, 0),
+            _mm512_setr_epi64(2, 3, 10, 11, 0, 0, 0, 0),
+            _mm512_setr_epi64(4, 5, 12, 13, 0, 0, 0, 0),
+            _mm512_setr_epi64(6, 7, 14, 15, 0, 0, 0, 0),
+    };
+    for (size_t y = 0; y < 4; ++y) {
+        const __m512i last = _mm512_set1_epi64(static_cast<long long>((4 + 3 * y) % 5));
+        a.row[y] = _mm512_mask_permutexvar_epi64(_mm512_permutex2var_epi64(b01, pair[y], b23), 0x10, last, b[4]);
+    }
+    // Output row 4 takes lanes 2, 3, 4, 0 and 1 of rows 0 to 4.
+    const __m512i r4 = _mm512_permutex2var_epi64(b[0], _mm512_setr_epi64(2, 11, 0, 0, 0, 0, 0, 0), b[1]);
+    const __m512i r4_23 = _mm512_permutex2var_epi64(r4, _mm512_setr_epi64(0, 1, 12, 8, 0, 0, 0, 0), b[2]);
+    const __m512i r4_3 = _mm512_mask_permutexvar_epi64(r4_23, 0x08, _mm512_set1_epi64(0), b[3]);
+    a.row[4] = _mm512_mask_permutexvar_epi64(r4_3, 0x10, _mm512_set1_epi64(1), b[4]);
+
+    // Chi and Iota.
+    for (size_t y = 0; y < 5; ++y) {
+        a.row[y] = _mm512_ternarylogic_epi64(a.row[y], _mm512_permutexvar_epi64(next, a.row[y]),
+                                             _mm512_permutexvar_epi64(next2, a.row[y]), 0xd2);
+    }
+    a.row[0] = _mm512_mask_xor_epi64(a.row[0], 0x01, a.row[0], _mm512_set1_epi64(static_cast<long long>(rc)));
+}
+
+template<size_t N_R>
+KECCAK_FORCE_INLINE void rounds(Rows &a) {
+    for (size_t index = ROUNDS - N_R; index < ROUNDS; ++index) round(a, round_constants[index]);
+}
+
+KECCAK_FORCE_INLINE auto load_rows(const std::array<uint64_t, P_LEN> &state) -> Rows {
+    Rows a;
+    for (size_t y = 0; y < 5; ++y) a.row[y] = _mm512_maskz_loadu_epi64(ROW, state.data() + 5 * y);
+    return a;
+}
+
+KECCAK_FORCE_INLINE void store_rows(std::array<uint64_t, P_LEN> &state, const Rows &a) {
+    for (size_t y = 0; y < 5; ++y) _mm512_mask_storeu_epi64(state.data() + 5 * y, ROW, a.row[y]);
+}
+
+} // namespace
+
+template<size_t N_R>
+void keccak_p_x8(uint64_t *states) {
+    simd::keccak_p<Avx512, N_R>(states);
+}
+
+template void keccak_p_x8<ROUNDS>(uint64_t *states);
+template void keccak_p_x8<12>(uint64_t *states);
+
+template<size_t N_R>
+void keccak_p_avx512(std::array<uint64_t, P_LEN> &state) {
+    Rows a = load_rows(state);
+    rounds<N_R>(a);
+    store_rows(state, a);
+}
+
+template<size_t N_R>
+void absorb_avx512(std::array<uint64_t, P_LEN> &state, const uint8_t *data, size_t blocks, size_t rate_words) {
+    // The words of a block fill the rows in order, the last one partly.
+    __mmask8 masks[5];
+    for (size_t y = 0; y < 5; ++y) {
+        const size_t words = rate_words > 5 * y + 5 ? 5 : rate_words > 5 * y ? rate_words - 5 * y : 0;
+        masks[y] = static_cast<__mmask8>((1u << words) - 1);
+    }
+
+    Rows a = load_rows(state);
+    for (; blocks > 0; --blocks, data += rate_words * sizeof(uint64_t)) {
+        const auto *words = reinterpret_cast<const uint64_t *>(data);
+        for (size_t y = 0; y < 5; ++y) {
+            a.row[y] = _mm512_xor_si512(a.row[y], _mm512_maskz_loadu_epi64(masks[y], words + 5 * y));
+        }
+        rounds<N_R>(a);
+    }
+    store_rows(state, a);
+}
+
+template void keccak_p_avx512<ROUNDS>(std::array<uint64_t, P_LEN> &state);
+template void keccak_p_avx512<12>(std::array<uint64_t, P_LEN> &state);
+template void absorb_avx512<ROUNDS>(std::array<uint64_t, P_LEN> &state, const uint8_t *data, size_t blocks, size_t rate_words);
+template void absorb_avx512<12>(std::array<uint64_t, P_LEN> &state, const uint8_t *data, size_t blocks, size_t rate_words);
+
+} // namespace keccak::core
+
+#endif
@@ -0,0 +1,24 @@
+#include "kernels.h"
+
+#if defined(__BMI2__)
+
+namespace keccak::core {
+
+template<size_t N_R>
+void keccak_p_bmi2(std::array<uint64_t, P_LEN> &state) {
+    keccak_p_unrolled<N_R>(state);
+}
+
+template<size_t N_R>
+void absorb_bmi2(std::array<uint64_t, P_LEN> &state, const uint8_t *data, size_t blocks, size_t rate_words) {
+    absorb_rates<keccak_p_unrolled<N_R>>(state, data, blocks, rate_words);
+}
+
+template void keccak_p_bmi2<ROUNDS>(std::array<uint64_t, P_LEN> &state);
+template void keccak_p_bmi2<12>(std::array<uint64_t, P_LEN> &state);
+template void absorb_bmi2<ROUNDS>(std::array<uint64_t, P_LEN> &state, const uint8_t *data, size_t blocks, size_t rate_words);
+template void absorb_bmi2<12>(std::array<uint64_t, P_LEN> &state, const uint8_t *data, size_t blocks, size_t rate_words);
+
+} // namespace keccak::core
+
+#endif
@@ -0,0 +1,38 @@
+#include "keccak_interleaved.h"
+#include "kernels.h"
+
+namespace keccak::core {
+
+template<size_t N_R>
+void keccak_p_bit_interleaved(std::array<uint64_t, P_LEN> &state) {
+    interleaved_state a{};
+    interleave(state, a);
+    keccak_p_interleaved<N_R>(a);
+    deinterleave(a, state);
+}
+
+template<size_t N_R>
+void absorb_bit_interleaved(std::array<uint64_t, P_LEN> &state, const uint8_t *data, size_t blocks,
+                            size_t rate_words) {
+    // The state stays interleaved across the blocks; only the input words are converted.
+    interleaved_state a{};
+    interleave(state, a);
+    for (; blocks > 0; --blocks) {
+        for (size_t i = 0; i < rate_words; ++i, data += sizeof(uint64_t)) {
+            const uint64_t word = load_le64(data);
+            uint32_t even = 0, odd = 0;
+            interleave(static_cast<uint32_t>(word), static_cast<uint32_t>(word >> 32), even, odd);
+            a[2 * i] ^= even;
+            a[2 * i + 1] ^= odd;
+        }
+        keccak_p_interleaved<N_R>(a);
+    }
+    deinterleave(a, state);
+}
+
+template void keccak_p_bit_interleaved<ROUNDS>(std::array<uint64_t, P_LEN> &state);
+template void keccak_p_bit_interleaved<12>(std::array<uint64_t, P_LEN> &state);
+template void absorb_bit_interleaved<ROUNDS>(std::array<uint64_t, P_LEN> &state, const uint8_t *data, size_t blocks, size_t rate_words);
+template void absorb_bit_interleaved<12>(std::array<uint64_t, P_LEN> &state, const uint8_t *data, size_t blocks, size_t rate_words);
+
+} // namespace keccak::core
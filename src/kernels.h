@@ -0,0 +1,131 @@
+#ifndef KECCAK_KERNELS_H
+#define KECCAK_KERNELS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "keccak.h"
+
+/**
+ * @brief The single-state kernels, each built in its own translation unit with its own instruction set.
+ */
+namespace keccak::core {
+
+/**
+ * @brief The unrolled permutation built for baseline x86-64 or any other target.
+ * @tparam N_R The number of rounds, 24 or 12.
+ * @param state The state to operate on.
+ */
+template<size_t N_R>
+void keccak_p_scalar(std::array<uint64_t, P_LEN> &state);
+
+/**
+ * @brief The unrolled permutation built with BMI1/BMI2 (RORX, ANDN).
+ * @tparam N_R The number of rounds, 24 or 12.
+ * @param state The state to operate on.
+ */
+template<size_t N_R>
+void keccak_p_bmi2(std::array<uint64_t, P_LEN> &state);
+
+/**
+ * @brief The block absorb loop around `keccak_p_scalar`.
+ * @tparam N_R The number of rounds, 24 or 12.
+ * @param state The state to operate on, at the start of a block.
+ * @param data The blocks.
+ * @param blocks The number of blocks.
+ * @param rate_words The rate in words.
+ */
+template<size_t N_R>
+void absorb_scalar(std::array<uint64_t, P_LEN> &state, const uint8_t *data, size_t blocks, size_t rate_words);
+
+/**
+ * @brief The block absorb loop around `keccak_p_bmi2`.
+ * @tparam N_R The number of rounds, 24 or 12.
+ * @param state The state to operate on, at the start of a block.
+ * @param data The blocks.
+ * @param blocks The number of blocks.
+ * @param rate_words The rate in words.
+ */
+template<size_t N_R>
+void absorb_bmi2(std::array<uint64_t, P_LEN> &state, const uint8_t *data, size_t blocks, size_t rate_words);
+
+/**
+ * @brief The bit-interleaved permutation for 32-bit targets, converting the state on the way in and out.
+ * @tparam N_R The number of rounds, 24 or 12.
+ * @param state The state to operate on.
+ */
+template<size_t N_R>
+void keccak_p_bit_interleaved(std::array<uint64_t, P_LEN> &state);
+
+/**
+ * @brief The block absorb loop around the bit-interleaved permutation, interleaving the input instead of the state.
+ * @tparam N_R The number of rounds, 24 or 12.
+ * @param state The state to operate on, at the start of a block.
+ * @param data The blocks.
+ * @param blocks The number of blocks.
+ * @param rate_words The rate in words.
+ */
+template<size_t N_R>
+void absorb_bit_interleaved(std::array<uint64_t, P_LEN> &state, const uint8_t *data, size_t blocks,
+                            size_t rate_words);
+
+/**
+ * @brief The permutation built with AVX-512, one state held as five rows of five lanes in ZMM registers.
+ * @tparam N_R The number of rounds, 24 or 12.
+ * @param state The state to operate on.
+ */
+template<size_t N_R>
+void keccak_p_avx512(std::array<uint64_t, P_LEN> &state);
+
+/**
+ * @brief The block absorb loop around `keccak_p_avx512`, keeping the state in registers between blocks.
+ * @tparam N_R The number of rounds, 24 or 12.
+ * @param state The state to operate on, at the start of a block.
+ * @param data The blocks.
+ * @param blocks The number of blocks.
+ * @param rate_words The rate in words.
+ */
+template<size_t N_R>
+void absorb_avx512(std::array<uint64_t, P_LEN> &state, const uint8_t *data, size_t blocks, size_t rate_words);
+
+namespace {
+
+template<size_t RATE_WORDS, void (*PERMUTE)(std::array<uint64_t, P_LEN> &)>
+KECCAK_FORCE_INLINE void absorb_blocks(std::array<uint64_t, P_LEN> &state, const uint8_t *data, size_t blocks) {
+    for (; blocks > 0; --blocks, data += RATE_WORDS * sizeof(uint64_t)) {
+        for (size_t i = 0; i < RATE_WORDS; ++i) state[i] ^= load_le64(data + i * sizeof(uint64_t));
+        PERMUTE(state);
+    }
+}
+
+/**
+ * @brief Absorb with the rate folded into the loop for the rates of SHA3, Keccak and SHAKE.
+ */
+template<void (*PERMUTE)(std::array<uint64_t, P_LEN> &)>
+KECCAK_FORCE_INLINE void absorb_rates(std::array<uint64_t, P_LEN> &state, const uint8_t *data, size_t blocks,
+                                      size_t rate_words) {
+    switch (rate_words) {
+        case 21:
+            return absorb_blocks<21, PERMUTE>(state, data, blocks);
+        case 18:
+            return absorb_blocks<18, PERMUTE>(state, data, blocks);
+        case 17:
+            return absorb_blocks<17, PERMUTE>(state, data, blocks);
+        case 13:
+            return absorb_blocks<13, PERMUTE>(state, data, blocks);
+        case 9:
+            return absorb_blocks<9, PERMUTE>(state, data, blocks);
+        default:
+            for (; blocks > 0; --blocks) {
+                for (size_t i = 0; i < rate_words; ++i, data += sizeof(uint64_t)) state[i] ^= load_le64(data);
+                PERMUTE(state);
+            }
+    }
+}
+
+} // namespace
+
+} // namespace keccak::core
+
+#endif //KECCAK_KERNELS_H
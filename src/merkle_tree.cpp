@@ -0,0 +1,132 @@
+#include "merkle_tree.h"
+
+#include <algorithm>
+#include <cassert>
+#include <future>
+
+#include "multi_buffer.h"
+#include "sponge.h"
+
+namespace keccak {
+namespace {
+
+using Node = MerkleTree::Node;
+
+/// The words of one node.
+constexpr size_t NODE_WORDS = sizeof(Node) / sizeof(uint64_t);
+/// The first word of the Keccak padding, right after a 64-byte message.
+constexpr size_t PAD_WORD = 2 * NODE_WORDS;
+
+/**
+ * @brief Hash `count` parents from their adjacent children, several at once with the multi-buffer permutation.
+ *
+ * A pair of children is 64 bytes, so every parent is a single padded block.
+ */
+void hash_pairs(const Node *children, size_t count, Node *parents) {
+    const size_t lanes = core::multi_buffer_lanes();
+
+    size_t next = 0;
+    if (lanes > 1) {
+        std::array<uint64_t, core::P_LEN * core::MAX_LANES> states{};
+        for (; next + lanes <= count; next += lanes) {
+            std::fill(states.begin(), states.end(), 0);
+            for (size_t lane = 0; lane < lanes; ++lane) {
+                for (size_t i = 0; i < 2 * NODE_WORDS; ++i) {
+                    const auto *child = children[2 * (next + lane) + i / NODE_WORDS].data();
+                    states[i * lanes + lane] = core::load_le64(child + (i % NODE_WORDS) * sizeof(uint64_t));
+                }
+                states[PAD_WORD * lanes + lane] = 0x01;
+                states[(Keccak256::RATE_WORDS - 1) * lanes + lane] = 0x8000000000000000ULL;
+            }
+            core::keccak_p_many(states.data(), lanes);
+            for (size_t lane = 0; lane < lanes; ++lane) {
+                for (size_t i = 0; i < NODE_WORDS; ++i) {
+                    core::store_le64(parents[next + lane].data() + i * sizeof(uint64_t), states[i * lanes + lane]);
+                }
+            }
+        }
+    }
+
+    for (; next < count; ++next) parents[next] = MerkleTree::hash_pair(children[2 * next], children[2 * next + 1]);
+}
+
+} // namespace
+
+MerkleTree::MerkleTree(std::span<const Node> leaves) : MerkleTree(leaves, nullptr) {}
+
+MerkleTree::MerkleTree(std::span<const Node> leaves, ThreadPool &pool) : MerkleTree(leaves, &pool) {}
+
+MerkleTree::MerkleTree(std::span<const Node> leaves, ThreadPool *pool) : nodes{}, offsets{0}, pool{pool} {
+    assert(!leaves.empty());
+
+    for (size_t size = leaves.size(); ; size = (size + 1) / 2) {
+        this->offsets.push_back(this->offsets.back() + size);
+        if (size == 1) break;
+    }
+    this->nodes.resize(this->offsets.back());
+    std::copy(leaves.begin(), leaves.end(), this->nodes.begin());
+
+    for (size_t level = 1; level < this->depth(); ++level) this->build(level);
+}
+
+auto MerkleTree::root() const -> const Node & {
+    return this->nodes.back();
+}
+
+auto MerkleTree::depth() const -> size_t {
+    return this->offsets.size() - 1;
+}
+
+auto MerkleTree::level(size_t level) const -> std::span<const Node> {
+    assert(level < this->depth());
+    return {this->nodes.data() + this->offsets[level], this->offsets[level + 1] - this->offsets[level]};
+}
+
+void MerkleTree::update(size_t index, const Node &leaf) {
+    assert(index < this->offsets[1]);
+    this->nodes[index] = leaf;
+
+    for (size_t level = 1; level < this->depth(); ++level) {
+        const Node *children = this->nodes.data() + this->offsets[level - 1];
+        const size_t size = this->offsets[level] - this->offsets[level - 1];
+        const size_t left = index & ~static_cast<size_t>(1);
+        index /= 2;
+        this->nodes[this->offsets[level] + index] =
+                left + 1 < size ? MerkleTree::hash_pair(children[left], children[left + 1]) : children[left];
+    }
+}
+
+auto MerkleTree::hash_pair(const Node &left, const Node &right) -> Node {
+    Keccak256 sponge;
+    sponge.update(left.data(), left.size());
+    sponge.update(right.data(), right.size());
+    return sponge.digest();
+}
+
+void MerkleTree::build(size_t level) {
+    const Node *children = this->nodes.data() + this->offsets[level - 1];
+    Node *parents = this->nodes.data() + this->offsets[level];
+    const size_t size = this->offsets[level] - this->offsets[level - 1];
+    const size_t pairs = size / 2;
+
+    // The odd node out is promoted unchanged.
+    if (size % 2 == 1) parents[pairs] = children[size - 1];
+
+    if (this->pool == nullptr || pairs < 2 * MerkleTree::MIN_TASK_NODES) {
+        hash_pairs(children, pairs, parents);
+        return;
+    }
+
+    // A few tasks per worker even out the stealing; each task works through its range in lane-sized groups.
+    const size_t tasks = std::min(pairs / MerkleTree::MIN_TASK_NODES, 4 * this->pool->size());
+    const size_t per_task = (pairs + tasks - 1) / tasks;
+    std::vector<std::future<void>> pending;
+    pending.reserve(tasks);
+    for (size_t begin = 0; begin < pairs; begin += per_task) {
+        const size_t count = std::min(per_task, pairs - begin);
+        pending.push_back(this->pool->submit([=] { hash_pairs(children + 2 * begin, count, parents + begin); }));
+    }
+    for (auto &task: pending) task.get();
+}
+
+} // namespace keccak
@@ -0,0 +1,50 @@
+#include "multi_buffer.h"
+
+#include <array>
+#include <cassert>
+
+#include "dispatch.h"
+#include "instrumentation.h"
+
+namespace keccak::core {
+
+auto multi_buffer_lanes() -> size_t {
+#ifdef KECCAK_REFERENCE_PERMUTATION
+    // The reference build runs every state on the reference permutation, one at a time.
+    return 1;
+#else
+    return kernels().lanes;
+#endif
+}
+
+void keccak_p_many(uint64_t *states, size_t lanes, size_t rounds) {
+    assert(rounds == ROUNDS || rounds == 12);
+    instrumentation::count_multi_buffer(lanes);
+#ifdef KECCAK_REFERENCE_PERMUTATION
+    std::array<uint64_t, P_LEN> state{};
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        for (size_t i = 0; i < P_LEN; ++i) state[i] = states[i * lanes + lane];
+        if (rounds == ROUNDS) {
+            keccak_p_reference<ROUNDS>(state);
+        } else {
+            keccak_p_reference<12>(state);
+        }
+        for (size_t i = 0; i < P_LEN; ++i) states[i * lanes + lane] = state[i];
+    }
+#else
+    const Kernels &selected = kernels();
+    assert(lanes == selected.lanes);
+    const auto permute_many = rounds == ROUNDS ? selected.permute_many : selected.permute_many_12;
+    const auto permute = rounds == ROUNDS ? selected.permute : selected.permute_12;
+    if (permute_many != nullptr) return permute_many(states);
+
+    std::array<uint64_t, P_LEN> state{};
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        for (size_t i = 0; i < P_LEN; ++i) state[i] = states[i * lanes + lane];
+        permute(state);
+        for (size_t i = 0; i < P_LEN; ++i) states[i * lanes + lane] = state[i];
+    }
+#endif
+}
+
+} // namespace keccak::core
@@ -0,0 +1,7 @@
+#include "sha3_224.h"
+
+namespace keccak {
+
+SHA3_224::SHA3_224(uint8_t flag) : SHA3<224>(flag) {}
+
+} // namespace keccak
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace keccak {
+namespace {
+
+/// The pool and queue of the worker running on this thread, if any.
+thread_local const ThreadPool *current_pool = nullptr;
+thread_local size_t current_index = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(size_t workers) : pending{0}, next{0}, stopping{false} {
+    if (workers == 0) workers = std::max(1u, std::thread::hardware_concurrency());
+
+    for (size_t i = 0; i < workers; ++i) this->queues.push_back(std::make_unique<Queue>());
+    for (size_t i = 0; i < workers; ++i) this->workers.emplace_back([this, i] { this->run(i); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(this->mutex);
+        this->stopping = true;
+    }
+    this->wake.notify_all();
+    for (auto &worker: this->workers) worker.join();
+}
+
+auto ThreadPool::size() const -> size_t {
+    return this->workers.size();
+}
+
+void ThreadPool::push(std::function<void()> task) {
+    const size_t index = current_pool == this
+                         ? current_index
+                         : this->next.fetch_add(1, std::memory_order_relaxed) % this->queues.size();
+    // Counted before it is queued, so that the worker popping it never takes the count below zero.
+    {
+        std::lock_guard lock(this->mutex);
+        this->pending.fetch_add(1);
+    }
+    {
+        std::lock_guard lock(this->queues[index]->mutex);
+        this->queues[index]->tasks.push_back(std::move(task));
+    }
+    this->wake.notify_one();
+}
+
+auto ThreadPool::pop(size_t index, std::function<void()> &task) -> bool {
+    // The owner takes its newest task, thieves take the oldest of the others.
+    {
+        Queue &own = *this->queues[index];
+        std::lock_guard lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (size_t i = 1; i < this->queues.size(); ++i) {
+        Queue &victim = *this->queues[(index + i) % this->queues.size()];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run(size_t index) {
+    current_pool = this;
+    current_index = index;
+
+    std::function<void()> task;
+    while (true) {
+        if (this->pop(index, task)) {
+            this->pending.fetch_sub(1);
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock lock(this->mutex);
+        this->wake.wait(lock, [this] { return this->stopping || this->pending.load() > 0; });
+        if (this->stopping && this->pending.load() == 0) return;
+    }
+}
+
+} // namespace keccak
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "hash_service.h"
+#include "sha3.h"
+
+using namespace std::chrono_literals;
+
+TEST(TestHashService, Matches_One_Shot_From_Many_Threads) {
+    keccak::ThreadPool pool(2);
+    keccak::HashService<keccak::Keccak256> service(pool, 500us);
+
+    std::vector<std::thread> threads;
+    std::vector<std::vector<std::future<keccak::Keccak256::digest_type>>> futures(4);
+    for (size_t t = 0; t < futures.size(); ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t i = 0; i < 100; ++i) {
+                const std::vector<uint8_t> message(t * 100 + i, static_cast<uint8_t>(i));
+                futures[t].push_back(service.submit(message.data(), message.size()));
+            }
+        });
+    }
+    for (auto &thread: threads) thread.join();
+
+    for (size_t t = 0; t < futures.size(); ++t) {
+        for (size_t i = 0; i < futures[t].size(); ++i) {
+            const std::vector<uint8_t> message(t * 100 + i, static_cast<uint8_t>(i));
+            EXPECT_EQ(futures[t][i].get(), keccak::Keccak256::hash_digest(message.data(), message.size()));
+        }
+    }
+}
+
+TEST(TestHashService, Dispatches_Full_Batches_And_On_Deadline) {
+    keccak::ThreadPool pool(1);
+    std::future<keccak::SHA3Sponge<256>::digest_type> lone;
+    {
+        // A full batch goes at once, long before the deadline.
+        keccak::HashService service(pool, std::chrono::hours(1), 4);
+        std::vector<std::future<keccak::SHA3Sponge<256>::digest_type>> futures;
+        for (int i = 0; i < 4; ++i) futures.push_back(service.submit("abc", 3));
+        for (auto &future: futures) {
+            ASSERT_EQ(future.wait_for(10s), std::future_status::ready);
+            EXPECT_EQ(future.get(), keccak::SHA3Sponge<256>::hash_digest("abc", 3));
+        }
+
+        // A lone message waits for no longer than the deadline of its batch, or the shutdown.
+        lone = service.submit(std::vector<uint8_t>{'a'});
+        EXPECT_EQ(lone.wait_for(20ms), std::future_status::timeout);
+    }
+    ASSERT_EQ(lone.wait_for(10s), std::future_status::ready);
+    EXPECT_EQ(lone.get(), keccak::SHA3Sponge<256>::hash_digest("a", 1));
+
+    keccak::HashService service(pool, 1ms);
+    lone = service.submit("abc", 3);
+    ASSERT_EQ(lone.wait_for(10s), std::future_status::ready);
+    EXPECT_EQ(lone.get(), keccak::SHA3Sponge<256>::hash_digest("abc", 3));
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "instrumentation.h"
+#include "sha3.h"
+
+using keccak::instrumentation::size_bucket;
+
+static_assert(size_bucket(0) == 0);
+static_assert(size_bucket(1) == 1 && size_bucket(7) == 1);
+static_assert(size_bucket(8) == 2 && size_bucket(63) == 2);
+static_assert(size_bucket(64) == 3 && size_bucket(511) == 3);
+static_assert(size_bucket(256 * 1024) == keccak::instrumentation::SIZE_BUCKETS - 1);
+
+// Constant evaluation never counts.
+static_assert(keccak::Keccak256::hash_digest(std::string_view("abc"))[0] == 0x4e);
+
+TEST(TestInstrumentation, Counts_Updates_And_Permutations) {
+    keccak::instrumentation::reset();
+
+    std::vector<uint8_t> message(1000, 0x5a);
+    keccak::SHA3<256> sha3;
+    sha3.update(message.data(), 3);     // partial word
+    sha3.update(message.data(), 5);     // finishes the word, partial
+    sha3.update(message.data(), 992);   // whole words only
+    sha3.digest();
+
+    const auto counters = keccak::instrumentation::snapshot();
+    if constexpr (!keccak::instrumentation::ENABLED) {
+        EXPECT_EQ(counters.updates, 0);
+        EXPECT_EQ(counters.permutations, 0);
+        return;
+    }
+    EXPECT_EQ(counters.updates, 3);
+    EXPECT_EQ(counters.bytes_absorbed, 1000);
+    EXPECT_EQ(counters.partial_words, 2);
+    EXPECT_EQ(counters.update_sizes[1], 2);
+    EXPECT_EQ(counters.update_sizes[4], 1);
+    // 1000 bytes fill seven 136-byte blocks, and padding permutes once more.
+    EXPECT_EQ(counters.permutations, 8);
+    EXPECT_EQ(counters.multi_buffer_calls, 0);
+}
+
+TEST(TestInstrumentation, Aggregates_Exited_Threads) {
+    keccak::instrumentation::reset();
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([] { keccak::Keccak256::hash_digest(std::string_view("abc")); });
+    }
+    for (auto &thread: threads) thread.join();
+
+    const auto counters = keccak::instrumentation::snapshot();
+    EXPECT_EQ(counters.updates, keccak::instrumentation::ENABLED ? 4 : 0);
+    EXPECT_EQ(counters.partial_words, keccak::instrumentation::ENABLED ? 4 : 0);
+    EXPECT_EQ(counters.permutations, keccak::instrumentation::ENABLED ? 4 : 0);
+}
+
+TEST(TestInstrumentation, Counts_Fragments_As_One_Update) {
+    keccak::instrumentation::reset();
+
+    std::vector<std::byte> message(1000, std::byte{0x5a});
+    std::vector<std::span<const std::byte>> fragments;
+    for (size_t offset = 0; offset < message.size(); offset += 5) {
+        fragments.push_back(std::span(message).subspan(offset, 5));
+    }
+    keccak::SHA3Sponge<256>::hash_digest(fragments);
+
+    const auto counters = keccak::instrumentation::snapshot();
+    EXPECT_EQ(counters.updates, keccak::instrumentation::ENABLED ? 1 : 0);
+    EXPECT_EQ(counters.bytes_absorbed, keccak::instrumentation::ENABLED ? 1000 : 0);
+    EXPECT_EQ(counters.permutations, keccak::instrumentation::ENABLED ? 8 : 0);
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+#include "kangaroo_twelve.h"
+#include "turbo_shake.h"
+
+namespace {
+
+/// The ptn(n) test pattern of RFC 9861.
+auto ptn(size_t n) -> std::vector<uint8_t> {
+    std::vector<uint8_t> data(n);
+    for (size_t i = 0; i < n; ++i) data[i] = static_cast<uint8_t>(i % 251);
+    return data;
+}
+
+auto k12(const std::vector<uint8_t> &message, std::string_view customization) -> std::vector<uint8_t> {
+    std::vector<uint8_t> out(32);
+    keccak::K12::hash_buffer(message.data(), message.size(), out.data(), out.size(), customization);
+    return out;
+}
+
+auto hex(const std::vector<uint8_t> &bytes) -> std::string {
+    std::string s;
+    for (uint8_t b: bytes) {
+        s.push_back("0123456789abcdef"[b >> 4]);
+        s.push_back("0123456789abcdef"[b & 15]);
+    }
+    return s;
+}
+
+} // namespace
+
+TEST(TestKangarooTwelve, TurboSHAKE128_Empty) {
+    std::vector<uint8_t> out(32);
+    keccak::TurboSHAKE128::hash_buffer("", 0, out.data(), out.size());
+    EXPECT_EQ(hex(out), "1e415f1c5983aff2169217277d17bb538cd945a397ddec541f1ce41af2c1b74c");
+}
+
+TEST(TestKangarooTwelve, TurboSHAKE128_Domain) {
+    const auto message = ptn(17 * 17 * 17);
+    keccak::TurboSHAKE128 shake(0x0b);
+    shake.update(message.data(), message.size());
+    std::vector<uint8_t> out(32);
+    shake.squeeze(out.data(), out.size());
+    EXPECT_EQ(hex(out), "7b0fcc5dcc6d856035ecd2a17ec2d999c8b90574bbf209fc8069e3cf00ccad39");
+}
+
+TEST(TestKangarooTwelve, TurboSHAKE256_Pattern) {
+    const auto message = ptn(17 * 17 * 17);
+    std::vector<uint8_t> out(64);
+    keccak::TurboSHAKE256::hash_buffer(message.data(), message.size(), out.data(), out.size());
+    EXPECT_EQ(hex(out), "c74ebc919a5b3b0dd1228185ba02d29ef442d69d3d4276a93efe0bf9a16a7dc0"
+                        "cd4eabadab8cd7a5edd96695f5d360abe09e2c6511a3ec397da3b76b9e1674fb");
+}
+
+TEST(TestKangarooTwelve, K12_Empty) {
+    EXPECT_EQ(hex(k12({}, "")), "1ac2d450fc3b4205d19da7bfca1b37513c0803577ac7167f06fe2ce1f0ef39e5");
+}
+
+TEST(TestKangarooTwelve, K12_Long_Output) {
+    keccak::K12 k12;
+    std::vector<uint8_t> out(10032);
+    k12.squeeze(out.data(), 10000);
+    k12.squeeze(out.data() + 10000, 32);
+    EXPECT_EQ(hex({out.end() - 32, out.end()}), "e8dc563642f7228c84684c898405d3a834799158c079b12880277a1d28e2ff6d");
+}
+
+TEST(TestKangarooTwelve, K12_Single_Chunk) {
+    EXPECT_EQ(hex(k12(ptn(17 * 17 * 17), "")), "cb552e2ec77d9910701d578b457ddf772c12e322e4ee7fe417f92c758f0d59d0");
+}
+
+TEST(TestKangarooTwelve, K12_Customization_Crosses_Chunk) {
+    const auto customization = ptn(41 * 41);
+    EXPECT_EQ(hex(k12(ptn(8191), {reinterpret_cast<const char *>(customization.data()), customization.size()})),
+              "952bdb68d8215619a86e9262ea80ee5fc2f5cc64c0347b8e221cb7ec00b2cfdf");
+}
+
+TEST(TestKangarooTwelve, K12_Tree) {
+    EXPECT_EQ(hex(k12(ptn(8192 * 9 + 5), "")), "10980158ee01c2948156cdd8a377688d1c14276121aba618eefd7a907ec6ee41");
+}
+
+TEST(TestKangarooTwelve, K12_Tree_Streamed) {
+    const auto message = ptn(17 * 17 * 17 * 17 * 17);
+    const auto customization = ptn(41);
+
+    keccak::K12 k12({reinterpret_cast<const char *>(customization.data()), customization.size()});
+    for (size_t offset = 0; offset < message.size(); offset += 5000) {
+        k12.update(message.data() + offset, std::min<size_t>(5000, message.size() - offset));
+    }
+    std::vector<uint8_t> out(32);
+    k12.squeeze(out.data(), out.size());
+    EXPECT_EQ(hex(out), "308bb49b88e0a49a8b0f22b8da09b9a91cda16bd361cd8abdae14ee00cbc5583");
+    EXPECT_EQ(hex(::k12(message, {reinterpret_cast<const char *>(customization.data()), customization.size()})),
+              "308bb49b88e0a49a8b0f22b8da09b9a91cda16bd361cd8abdae14ee00cbc5583");
+}
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <random>
+#include <vector>
+
+#include "dispatch.h"
+#include "keccak.h"
+#include "keccak_interleaved.h"
+#include "multi_buffer.h"
+
+namespace {
+
+auto random_state(std::mt19937_64 &rng) -> std::array<uint64_t, keccak::core::P_LEN> {
+    std::array<uint64_t, keccak::core::P_LEN> state{};
+    for (auto &lane: state) lane = rng();
+    return state;
+}
+
+} // namespace
+
+TEST(TestKeccak, Reference_Matches_Unrolled) {
+    std::mt19937_64 rng(0x5eed);
+    for (int i = 0; i < 64; ++i) {
+        auto reference = random_state(rng);
+        auto unrolled = reference;
+
+        keccak::core::keccak_p_reference(reference);
+        keccak::core::keccak_p_unrolled(unrolled);
+        EXPECT_EQ(reference, unrolled);
+    }
+}
+
+TEST(TestKeccak, Unrolled_Constexpr) {
+    constexpr auto state = [] {
+        std::array<uint64_t, keccak::core::P_LEN> s{};
+        keccak::core::keccak_p_unrolled(s);
+        return s;
+    }();
+    static_assert(state[0] == 0xF1258F7940E1DDE7);
+    static_assert(state[24] == 0xEAF1FF7B5CECA249);
+}
+
+void expect_multi_buffer_matches_scalar(void (*kernel)(uint64_t *), size_t lanes) {
+    std::mt19937_64 rng(0xb0ff);
+
+    std::vector<std::array<uint64_t, keccak::core::P_LEN>> expected(lanes);
+    std::vector<uint64_t> states(keccak::core::P_LEN * lanes);
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        expected[lane] = random_state(rng);
+        for (size_t i = 0; i < keccak::core::P_LEN; ++i) states[i * lanes + lane] = expected[lane][i];
+        keccak::core::keccak_p(expected[lane]);
+    }
+
+    kernel(states.data());
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        for (size_t i = 0; i < keccak::core::P_LEN; ++i) EXPECT_EQ(states[i * lanes + lane], expected[lane][i]);
+    }
+}
+
+TEST(TestKeccak, Multi_Buffer_Matches_Scalar) {
+    for (auto kernel: {keccak::core::Kernel::AVX2, keccak::core::Kernel::AVX512}) {
+        if (const auto *kernels = keccak::core::kernels_for(kernel)) {
+            expect_multi_buffer_matches_scalar(kernels->permute_many, kernels->lanes);
+        }
+    }
+}
+
+TEST(TestKeccak, Kernels_Match_Reference) {
+    using keccak::core::Kernel;
+
+    ASSERT_NE(keccak::core::kernels_for(Kernel::SCALAR), nullptr);
+    for (auto kernel: {Kernel::SCALAR, Kernel::BMI2, Kernel::AVX2, Kernel::AVX512, Kernel::INTERLEAVED}) {
+        const auto *kernels = keccak::core::kernels_for(kernel);
+        if (kernels == nullptr) continue;
+
+        std::mt19937_64 rng(0xd15c);
+        for (int i = 0; i < 16; ++i) {
+            auto expected = random_state(rng);
+            auto state = expected;
+            keccak::core::keccak_p_reference(expected);
+            kernels->permute(state);
+            EXPECT_EQ(state, expected) << kernels->name;
+
+            expected = random_state(rng);
+            state = expected;
+            keccak::core::keccak_p_reference<12>(expected);
+            kernels->permute_12(state);
+            EXPECT_EQ(state, expected) << kernels->name << " (12 rounds)";
+        }
+    }
+}
+
+TEST(TestKeccak, Kernel_Absorb_Matches_Reference) {
+    using keccak::core::Kernel;
+
+    std::vector<uint8_t> data(21 * 8 * 3);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<uint8_t>(i * 29 + 3);
+
+    for (auto kernel: {Kernel::SCALAR, Kernel::BMI2, Kernel::AVX2, Kernel::AVX512, Kernel::INTERLEAVED}) {
+        const auto *kernels = keccak::core::kernels_for(kernel);
+        if (kernels == nullptr) continue;
+
+        // Every rate in use, and one no kernel folds.
+        for (size_t rate_words: {21, 18, 17, 13, 9, 5, 1}) {
+            std::mt19937_64 rng(rate_words);
+            auto expected = random_state(rng);
+            auto state = expected, state_12 = expected, expected_12 = expected;
+            for (size_t block = 0; block < 3; ++block) {
+                for (size_t i = 0; i < rate_words; ++i) {
+                    const uint64_t word = keccak::core::load_le64(data.data() + (block * rate_words + i) * 8);
+                    expected[i] ^= word;
+                    expected_12[i] ^= word;
+                }
+                keccak::core::keccak_p_reference(expected);
+                keccak::core::keccak_p_reference<12>(expected_12);
+            }
+            kernels->absorb(state, data.data(), 3, rate_words);
+            kernels->absorb_12(state_12, data.data(), 3, rate_words);
+            EXPECT_EQ(state, expected) << kernels->name << " rate " << rate_words;
+            EXPECT_EQ(state_12, expected_12) << kernels->name << " rate " << rate_words << " (12 rounds)";
+        }
+    }
+}
+
+TEST(TestKeccak, Interleaved_Matches_Reference) {
+    std::mt19937_64 rng(0x1e4f);
+    for (int i = 0; i < 64; ++i) {
+        const auto state = random_state(rng);
+
+        // Every lane splits into its even and odd bits, and back.
+        keccak::core::interleaved_state interleaved{};
+        keccak::core::interleave(state, interleaved);
+        for (size_t lane = 0; lane < keccak::core::P_LEN; ++lane) {
+            for (int bit = 0; bit < 64; ++bit) {
+                const uint32_t half = interleaved[2 * lane + bit % 2];
+                ASSERT_EQ(half >> (bit / 2) & 1, state[lane] >> bit & 1);
+            }
+        }
+        std::array<uint64_t, keccak::core::P_LEN> round_trip{};
+        keccak::core::deinterleave(interleaved, round_trip);
+        EXPECT_EQ(round_trip, state);
+
+        auto expected = state;
+        keccak::core::keccak_p_reference(expected);
+        keccak::core::keccak_p_interleaved(interleaved);
+        keccak::core::deinterleave(interleaved, round_trip);
+        EXPECT_EQ(round_trip, expected);
+    }
+
+    static_assert([] {
+        keccak::core::interleaved_state interleaved{};
+        std::array<uint64_t, keccak::core::P_LEN> state{};
+        keccak::core::keccak_p_interleaved(interleaved);
+        keccak::core::deinterleave(interleaved, state);
+        return state[0] == 0xF1258F7940E1DDE7 && state[24] == 0xEAF1FF7B5CECA249;
+    }());
+}
+
+#ifdef KECCAK_REFERENCE_PERMUTATION
+TEST(TestKeccak, Reference_Build_Has_No_Multi_Buffer) {
+    // hash_many and the tree modes group states by this, so one lane keeps them off the SIMD kernels.
+    EXPECT_EQ(keccak::core::multi_buffer_lanes(), 1);
+}
+#endif
@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "kmac.h"
+#include "sha3_256.h"
+
+namespace {
+
+constexpr uint8_t KEY[32] = {
+        0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4a, 0x4b, 0x4c, 0x4d, 0x4e, 0x4f,
+        0x50, 0x51, 0x52, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5a, 0x5b, 0x5c, 0x5d, 0x5e, 0x5f,
+};
+
+} // namespace
+
+TEST(TestKmac, KMAC128_Sample_1) {
+    uint8_t out[32];
+    keccak::KMAC128::hash_buffer(KEY, sizeof(KEY), "\x00\x01\x02\x03", 4, out, sizeof(out));
+    EXPECT_EQ(std::memcmp(out,
+                          "\xe5\x78\x0b\x0d\x3e\xa6\xf7\xd3\xa4\x29\xc5\x70\x6a\xa4\x3a\x00"
+                          "\xfa\xdb\xd7\xd4\x96\x28\x83\x9e\x31\x87\x24\x3f\x45\x6e\xe1\x4e", 32), 0);
+}
+
+TEST(TestKmac, KMAC128_Sample_2) {
+    uint8_t out[32];
+    keccak::KMAC128::hash_buffer(KEY, sizeof(KEY), "\x00\x01\x02\x03", 4, out, sizeof(out), "My Tagged Application");
+    EXPECT_EQ(std::memcmp(out,
+                          "\x3b\x1f\xba\x96\x3c\xd8\xb0\xb5\x9e\x8c\x1a\x6d\x71\x88\x8b\x71"
+                          "\x43\x65\x1a\xf8\xba\x0a\x70\x70\xc0\x97\x9e\x28\x11\x32\x4a\xa5", 32), 0);
+}
+
+TEST(TestKmac, KMAC256_Sample_4) {
+    keccak::KMAC256 kmac(KEY, sizeof(KEY), "My Tagged Application");
+    kmac.update("\x00\x01", 2);
+    kmac.update("\x02\x03", 2);
+    uint8_t out[64];
+    kmac.finalize(out, sizeof(out));
+    EXPECT_EQ(std::memcmp(out,
+                          "\x20\xc5\x70\xc3\x13\x46\xf7\x03\xc9\xac\x36\xc6\x1c\x03\xcb\x64"
+                          "\xc3\x97\x0d\x0c\xfc\x78\x7e\x9b\x79\x59\x9d\x27\x3a\x68\xd2\xf7"
+                          "\xf6\x9d\x4c\xc3\xde\x9d\x10\x4a\x35\x16\x89\xf2\x7c\xf6\xf5\x95"
+                          "\x1f\x01\x03\xf3\x3f\x4f\x24\x87\x10\x24\xd9\xc2\x77\x73\xa8\xdd", 64), 0);
+}
+
+TEST(TestKmac, KMACXOF_Incremental_Squeeze) {
+    std::vector<uint8_t> message(200);
+    for (size_t i = 0; i < message.size(); ++i) message[i] = static_cast<uint8_t>(i);
+
+    keccak::KMAC256 kmac(KEY, sizeof(KEY), "My Tagged Application");
+    kmac.update(message.data(), message.size());
+    uint8_t out[64];
+    kmac.squeeze(out, 5);
+    kmac.squeeze(out + 5, sizeof(out) - 5);
+    EXPECT_EQ(std::memcmp(out,
+                          "\xd5\xbe\x73\x1c\x95\x4e\xd7\x73\x28\x46\xbb\x59\xdb\xe3\xa8\xe3"
+                          "\x0f\x83\xe7\x7a\x4b\xff\x44\x59\xf2\xf1\xc2\xb4\xec\xeb\xb8\xce"
+                          "\x67\xba\x01\xc6\x2e\x8a\xb8\x57\x8d\x2d\x49\x9b\xd1\xbb\x27\x67"
+                          "\x68\x78\x11\x90\x02\x0a\x30\x6a\x97\xde\x28\x1d\xcc\x30\x30\x5d", 64), 0);
+}
+
+TEST(TestKmac, Midstate_Copy) {
+    static_assert(std::is_trivially_copyable_v<keccak::KMAC256>);
+    static_assert(std::is_trivially_copyable_v<keccak::SHA3_256>);
+
+    // Copies of a keyed instance MAC each message as a freshly keyed one would.
+    const keccak::KMAC256 keyed(KEY, sizeof(KEY), "session");
+    for (size_t length: {0, 1, 135, 136, 137, 1000}) {
+        std::vector<uint8_t> message(length, static_cast<uint8_t>(length));
+        keccak::KMAC256 copy = keyed;
+        copy.update(message.data(), message.size());
+        uint8_t expected[32], out[32];
+        copy.finalize(out, sizeof(out));
+        keccak::KMAC256::hash_buffer(KEY, sizeof(KEY), message.data(), message.size(), expected, sizeof(expected),
+                                     "session");
+        EXPECT_EQ(std::memcmp(out, expected, sizeof(out)), 0) << "length " << length;
+    }
+
+    // Likewise for a shared prefix, split in the middle of a word.
+    keccak::SHA3_256 prefix;
+    prefix.update("domain-tag:", 11);
+    keccak::SHA3_256 copy = prefix;
+    copy.update("message", 7);
+    EXPECT_EQ(copy.digest(), keccak::SHA3_256::hash_digest("domain-tag:message", 18));
+}
+
+TEST(TestKmac, Misuse_Throws) {
+    const keccak::KMAC128 keyed(KEY, sizeof(KEY));
+    uint8_t out[32];
+
+    keccak::KMAC128 finalized = keyed;
+    finalized.finalize(out, sizeof(out));
+    EXPECT_THROW(finalized.finalize(out, sizeof(out)), std::logic_error);
+    EXPECT_THROW(finalized.squeeze(out, sizeof(out)), std::logic_error);
+    EXPECT_THROW(finalized.update(out, sizeof(out)), std::logic_error);
+
+    keccak::KMAC128 xof = keyed;
+    xof.squeeze(out, sizeof(out));
+    EXPECT_THROW(xof.finalize(out, sizeof(out)), std::logic_error);
+    EXPECT_THROW(xof.update(out, sizeof(out)), std::logic_error);
+    EXPECT_NO_THROW(xof.squeeze(out, sizeof(out)));
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+#include "merkle_tree.h"
+#include "sha3_256.h"
+
+namespace {
+
+using Node = keccak::MerkleTree::Node;
+
+auto leaves(size_t count) -> std::vector<Node> {
+    std::vector<Node> nodes(count);
+    for (size_t i = 0; i < count; ++i) {
+        for (size_t j = 0; j < nodes[i].size(); ++j) nodes[i][j] = static_cast<uint8_t>(i * 31 + j * 7 + (i >> 8));
+    }
+    return nodes;
+}
+
+/**
+ * @brief The root the plain way: one legacy Keccak-256 `hash_buffer` per parent, promoting the odd node.
+ */
+auto reference_root(std::vector<Node> level) -> Node {
+    while (level.size() > 1) {
+        std::vector<Node> parents;
+        for (size_t i = 0; i + 1 < level.size(); i += 2) {
+            uint8_t pair[64];
+            std::memcpy(pair, level[i].data(), 32);
+            std::memcpy(pair + 32, level[i + 1].data(), 32);
+            const auto state = keccak::SHA3_256::hash_buffer(pair, sizeof(pair), 1);
+            Node parent;
+            std::memcpy(parent.data(), state.data(), parent.size());
+            parents.push_back(parent);
+        }
+        if (level.size() % 2 == 1) parents.push_back(level.back());
+        level = std::move(parents);
+    }
+    return level.front();
+}
+
+} // namespace
+
+TEST(TestMerkleTree, Zero_Pair) {
+    const Node zero{};
+    const auto parent = keccak::MerkleTree::hash_pair(zero, zero);
+    EXPECT_EQ(std::memcmp(parent.data(),
+                          "\xad\x32\x28\xb6\x76\xf7\xd3\xcd\x42\x84\xa5\x44\x3f\x17\xf1\x96"
+                          "\x2b\x36\xe4\x91\xb3\x0a\x40\xb2\x40\x58\x49\xe5\x97\xba\x5f\xb5", 32), 0);
+}
+
+TEST(TestMerkleTree, Matches_Reference) {
+    for (size_t count: {1, 2, 3, 5, 8, 9, 17, 100, 1001}) {
+        const auto nodes = leaves(count);
+        keccak::MerkleTree tree(nodes);
+        EXPECT_EQ(tree.root(), reference_root(nodes)) << count << " leaves";
+        EXPECT_EQ(tree.level(tree.depth() - 1).size(), 1);
+        EXPECT_EQ(tree.level(0).size(), count);
+    }
+}
+
+TEST(TestMerkleTree, Parallel_Build_And_Update) {
+    const auto nodes = leaves(20011);
+    keccak::ThreadPool pool(4);
+    keccak::MerkleTree tree(nodes, pool);
+    keccak::MerkleTree serial(nodes);
+    EXPECT_EQ(tree.root(), reference_root(nodes));
+    for (size_t level = 0; level < tree.depth(); ++level) {
+        const auto a = tree.level(level), b = serial.level(level);
+        EXPECT_TRUE(std::equal(a.begin(), a.end(), b.begin(), b.end())) << "level " << level;
+    }
+
+    // Updating single leaves recomputes their paths, including the promoted last one.
+    auto changed = nodes;
+    for (size_t index: {size_t{0}, size_t{12345}, nodes.size() - 1}) {
+        changed[index][0] ^= 0xff;
+        tree.update(index, changed[index]);
+        EXPECT_EQ(tree.root(), keccak::MerkleTree(changed).root()) << "leaf " << index;
+    }
+}
@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+#include <tuple>
+#include <vector>
+
+#include "multi_digest.h"
+#include "shake.h"
+
+namespace {
+
+auto message(size_t length) -> std::vector<uint8_t> {
+    std::vector<uint8_t> data(length);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<uint8_t>(i * 7 + 3);
+    return data;
+}
+
+} // namespace
+
+TEST(TestMultiDigest, Matches_Separate_Hashes) {
+    using Multi = keccak::MultiDigest<keccak::SHA3Sponge<256>, keccak::Keccak256, keccak::SHA3Sponge<512>,
+            keccak::SHA3Sponge<224>, keccak::Keccak384>;
+
+    for (size_t length: {0, 1, 71, 72, 135, 136, 137, 1000, 16384, 40000, 100003}) {
+        const auto data = message(length);
+        const auto [sha3_256, keccak_256, sha3_512, sha3_224, keccak_384] = Multi::hash_buffer(data.data(), length);
+        EXPECT_EQ(sha3_256, keccak::SHA3Sponge<256>::hash_digest(data.data(), length)) << length;
+        EXPECT_EQ(keccak_256, keccak::Keccak256::hash_digest(data.data(), length)) << length;
+        EXPECT_EQ(sha3_512, keccak::SHA3Sponge<512>::hash_digest(data.data(), length)) << length;
+        EXPECT_EQ(sha3_224, keccak::SHA3Sponge<224>::hash_digest(data.data(), length)) << length;
+        EXPECT_EQ(keccak_384, keccak::Keccak384::hash_digest(data.data(), length)) << length;
+    }
+}
+
+TEST(TestMultiDigest, Streaming) {
+    const auto data = message(50000);
+    keccak::SHA3_256_Keccak256 whole, pieces;
+    whole.update(data.data(), data.size());
+    for (size_t offset = 0, step = 1; offset < data.size(); offset += step, step = step * 5 % 997 + 1) {
+        pieces.update(data.data() + offset, std::min(step, data.size() - offset));
+        // Reading the hashes midway leaves the stream untouched.
+        if (step % 7 == 0) std::ignore = pieces.digests();
+    }
+    EXPECT_EQ(whole.digests(), pieces.digests());
+    EXPECT_EQ(std::get<1>(whole.digests()), keccak::Keccak256::hash_digest(data.data(), data.size()));
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#include "cshake.h"
+#include "parallel_hash.h"
+
+namespace {
+
+constexpr uint8_t SAMPLE[24] = {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+        0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+        0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27,
+};
+
+auto message(size_t length) -> std::vector<uint8_t> {
+    std::vector<uint8_t> data(length);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<uint8_t>(i * 7 + 3);
+    return data;
+}
+
+} // namespace
+
+TEST(TestParallelHash, CSHAKE128_Sample_1) {
+    keccak::CSHAKE128 cshake("", "Email Signature");
+    cshake.update("\x00\x01\x02\x03", 4);
+    uint8_t out[32];
+    cshake.squeeze(out, sizeof(out));
+    EXPECT_EQ(std::memcmp(out,
+                          "\xc1\xc3\x69\x25\xb6\x40\x9a\x04\xf1\xb5\x04\xfc\xbc\xa9\xd8\x2b"
+                          "\x40\x17\x27\x7c\xb5\xed\x2b\x20\x65\xfc\x1d\x38\x14\xd5\xaa\xf5", 32), 0);
+}
+
+TEST(TestParallelHash, ParallelHash128_Sample_1) {
+    keccak::ParallelHash128 hash(8, "", 2);
+    hash.update(SAMPLE, sizeof(SAMPLE));
+    uint8_t out[32];
+    hash.finalize(out, sizeof(out));
+    EXPECT_EQ(std::memcmp(out,
+                          "\xba\x8d\xc1\xd1\xd9\x79\x33\x1d\x3f\x81\x36\x03\xc6\x7f\x72\x60"
+                          "\x9a\xb5\xe4\x4b\x94\xa0\xb8\xf9\xaf\x46\x51\x44\x54\xa2\xb4\xf5", 32), 0);
+}
+
+TEST(TestParallelHash, ParallelHash128_Sample_2) {
+    keccak::ParallelHash128 hash(8, "Parallel Data", 2);
+    hash.update(SAMPLE, sizeof(SAMPLE));
+    uint8_t out[32];
+    hash.finalize(out, sizeof(out));
+    EXPECT_EQ(std::memcmp(out,
+                          "\xfc\x48\x4d\xcb\x3f\x84\xdc\xee\xdc\x35\x34\x38\x15\x1b\xee\x58"
+                          "\x15\x7d\x6e\xfe\xd0\x44\x5a\x81\xf1\x65\xe4\x95\x79\x5b\x72\x06", 32), 0);
+}
+
+TEST(TestParallelHash, ParallelHash256_Sample_5) {
+    keccak::ParallelHash256 hash(8, "Parallel Data", 2);
+    hash.update(SAMPLE, sizeof(SAMPLE));
+    uint8_t out[64];
+    hash.finalize(out, sizeof(out));
+    EXPECT_EQ(std::memcmp(out,
+                          "\xcd\xf1\x52\x89\xb5\x4f\x62\x12\xb4\xbc\x27\x05\x28\xb4\x95\x26"
+                          "\x00\x6d\xd9\xb5\x4e\x2b\x6a\xdd\x1e\xf6\x90\x0d\xda\x39\x63\xbb"
+                          "\x33\xa7\x24\x91\xf2\x36\x96\x9c\xa8\xaf\xae\xa2\x9c\x68\x2d\x47"
+                          "\xa3\x93\xc0\x65\xb3\x8e\x29\xfa\xe6\x51\xa2\x09\x1c\x83\x31\x10", 64), 0);
+}
+
+TEST(TestParallelHash, ParallelHash128_Streaming_Shared_Pool) {
+    const auto data = message(200003);
+    keccak::ThreadPool pool(4);
+
+    // Many tasks in flight, fed in pieces that straddle task boundaries.
+    keccak::ParallelHash128 hash(1024, "stream", pool);
+    for (size_t offset = 0; offset < data.size(); offset += 9973) {
+        hash.update(data.data() + offset, std::min<size_t>(9973, data.size() - offset));
+    }
+    uint8_t out[32];
+    hash.finalize(out, sizeof(out));
+    EXPECT_EQ(std::memcmp(out,
+                          "\x65\x92\xf3\x4f\x1e\x44\x65\x0d\x31\x39\x93\xec\x57\x48\x4c\xba"
+                          "\x98\xca\xc7\x32\xbb\xdc\x6c\x83\xe6\x52\xff\x52\xc4\xc6\xb8\xc5", 32), 0);
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "duplex_random.h"
+#include "shake.h"
+
+static_assert(std::uniform_random_bit_generator<keccak::DuplexRandom128>);
+
+TEST(TestRandom, Streams_SHAKE_Of_Seed) {
+    uint8_t seed[8] = {0x2a};
+    std::vector<uint8_t> expected(1000);
+    keccak::SHAKE128::hash_buffer(seed, sizeof(seed), expected.data(), expected.size());
+
+    keccak::DuplexRandom128 random(42);
+    std::vector<std::byte> out(expected.size());
+    random.fill(out);
+    EXPECT_EQ(std::memcmp(out.data(), expected.data(), out.size()), 0);
+
+    const std::array<std::byte, 5> text = {std::byte{'s'}, std::byte{'e'}, std::byte{'e'}, std::byte{'d'},
+                                           std::byte{'!'}};
+    keccak::SHAKE256::hash_buffer(text.data(), text.size(), expected.data(), expected.size());
+    keccak::DuplexRandom256 seeded(text);
+    seeded.fill(out);
+    EXPECT_EQ(std::memcmp(out.data(), expected.data(), out.size()), 0);
+}
+
+TEST(TestRandom, Words_And_Fill_Agree) {
+    keccak::DuplexRandom128 words(7), bytes(7);
+    for (size_t i = 0; i < 100; ++i) {
+        std::array<std::byte, 8> out{};
+        bytes.fill(out);
+        EXPECT_EQ(words(), keccak::core::load_le64(out.data())) << "word " << i;
+    }
+
+    // Fills of any size cut the same stream.
+    keccak::DuplexRandom128 whole(9), pieces(9);
+    std::vector<std::byte> a(2000), b(2000);
+    whole.fill(a);
+    for (size_t offset = 0, step = 1; offset < b.size(); offset += step, step = step * 3 % 401 + 1) {
+        pieces.fill(std::span(b).subspan(offset, std::min(step, b.size() - offset)));
+    }
+    EXPECT_EQ(a, b);
+}
+
+TEST(TestRandom, Reseed_And_Fork) {
+    keccak::DuplexRandom128 random(1);
+    const keccak::DuplexRandom128 start = random;
+
+    const auto first = random.fork(1), again = random.fork(1), other = random.fork(2);
+    EXPECT_EQ(first.fork(0)(), again.fork(0)());
+    auto a = first, b = other;
+    EXPECT_NE(a(), b());
+    // Forking leaves the parent untouched.
+    auto replay = start;
+    EXPECT_EQ(random(), replay());
+
+    const std::array<std::byte, 1> extra = {std::byte{1}};
+    auto reseeded = start;
+    reseeded.reseed(extra);
+    auto plain = start;
+    EXPECT_NE(reseeded(), plain());
+}
+
+TEST(TestRandom, Distribution) {
+    keccak::DuplexRandom128 random(3);
+    std::uniform_int_distribution<int> die(1, 6);
+    std::array<int, 7> counts{};
+    for (int i = 0; i < 60000; ++i) ++counts[die(random)];
+    for (int face = 1; face <= 6; ++face) EXPECT_NEAR(counts[face], 10000, 500) << "face " << face;
+}
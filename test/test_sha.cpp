@@ -1,6 +1,17 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <array>
-
+#include <cstddef>
+#include <cstring>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sha3_224.h"
 #include "sha3_256.h"
 #include "sha3_384.h"
 #include "sha3_512.h"
@@ -92,6 +103,245 @@ TEST(TestSha, SHA3_256_Buffer) {
                           "\x85\x5f\x08\x6e\x3e\x9d\x52\x5b\x46\xbf\xe2\x45\x11\x43\x15\x32", 32), 0);
 }
 
+TEST(TestSha, SHA3_256_Digest) {
+    constexpr std::array<uint8_t, 32> expected = {
+            0x3a, 0x98, 0x5d, 0xa7, 0x4f, 0xe2, 0x25, 0xb2, 0x04, 0x5c, 0x17, 0x2d, 0x6b, 0xd3, 0x90, 0xbd,
+            0x85, 0x5f, 0x08, 0x6e, 0x3e, 0x9d, 0x52, 0x5b, 0x46, 0xbf, 0xe2, 0x45, 0x11, 0x43, 0x15, 0x32,
+    };
+    static_assert(std::is_same_v<keccak::SHA3_256::digest_type, std::array<uint8_t, 32>>);
+    EXPECT_EQ(keccak::SHA3_256::hash_digest("abc", 3), expected);
+
+    keccak::SHA3_256 sha3(0);
+    sha3.update("abc", 3);
+    EXPECT_EQ(sha3.digest(), expected);
+
+    // Only the digest bytes of the caller buffer are written.
+    std::array<std::byte, 40> out{};
+    out.fill(std::byte{0xee});
+    keccak::SHA3_256 into(0);
+    into.update("abc", 3);
+    into.finalize_into(std::span(out).first<32>());
+    EXPECT_EQ(std::memcmp(out.data(), expected.data(), 32), 0);
+    for (size_t i = 32; i < out.size(); ++i) EXPECT_EQ(out[i], std::byte{0xee});
+}
+
+TEST(TestSha, Sponge_Variants) {
+    static_assert(keccak::Keccak256::RATE_WORDS == 17 && keccak::SHA3Sponge<512>::RATE_WORDS == 9);
+
+    // The compile-time Keccak sponge agrees with the runtime flag.
+    auto keccak = keccak::Keccak256::hash_digest("abc", 3);
+    EXPECT_EQ(keccak, keccak::SHA3_256::hash_digest("abc", 3, 1));
+    EXPECT_EQ(std::memcmp(keccak.data(),
+                          "\x4e\x03\x65\x7a\xea\x45\xa9\x4f\xc7\xd4\x7b\xa8\x26\xc8\xd6\x67"
+                          "\xc0\xd1\xe6\xe3\x3a\x64\xa0\x36\xec\x44\xf5\x8f\xa1\x2d\x6c\x45", 32), 0);
+
+    keccak::SHA3Sponge<512> sha3;
+    sha3.update("abc", 3);
+    EXPECT_EQ(sha3.digest(), keccak::SHA3_512::hash_digest("abc", 3));
+
+    // The hash of SHA3-224 ends in the middle of a lane.
+    auto sha3_224 = keccak::SHA3Sponge<224>::hash_digest("abc", 3);
+    static_assert(sizeof(sha3_224) == 28);
+    EXPECT_EQ(std::memcmp(sha3_224.data(),
+                          "\xe6\x42\x82\x4c\x3f\x8c\xf2\x4a\xd0\x92\x34\xee\x7d\x3c\x76\x6f"
+                          "\xc9\xa3\xa5\x16\x8d\x0c\x94\xad\x73\xb4\x6f\xdf", 28), 0);
+    keccak::SHA3_224 runtime(0);
+    runtime.update("abc", 3);
+    EXPECT_EQ(runtime.digest(), sha3_224);
+}
+
+namespace {
+
+template<typename SPONGE, size_t N>
+void expect_fixed(const uint8_t *message) {
+    EXPECT_EQ(SPONGE::template hash_fixed<N>(message), SPONGE::hash_digest(message, N)) << N;
+}
+
+template<typename SPONGE, size_t... N>
+void expect_fixed(std::index_sequence<N...>) {
+    std::array<uint8_t, SPONGE::RATE_BYTES> message{};
+    for (size_t i = 0; i < message.size(); ++i) message[i] = static_cast<uint8_t>(i * 7 + 1);
+    (expect_fixed<SPONGE, N>(message.data()), ...);
+}
+
+template<typename SPONGE>
+void expect_fixed() {
+    constexpr size_t LAST = SPONGE::RATE_BYTES - 1;
+    expect_fixed<SPONGE>(std::index_sequence<0, 1, 7, 8, 9, 20, 32, 64, LAST - 8, LAST - 1, LAST>{});
+}
+
+} // namespace
+
+TEST(TestSha, Hash_Fixed) {
+    expect_fixed<keccak::SHA3Sponge<224>>();
+    expect_fixed<keccak::SHA3Sponge<256>>();
+    expect_fixed<keccak::SHA3Sponge<384>>();
+    expect_fixed<keccak::SHA3Sponge<512>>();
+    expect_fixed<keccak::Keccak256>();
+    expect_fixed<keccak::Keccak512>();
+
+    // The fast path also runs in constant evaluation.
+    constexpr std::array<std::byte, 3> abc = {std::byte{'a'}, std::byte{'b'}, std::byte{'c'}};
+    constexpr auto keccak = keccak::Keccak256::hash_fixed(std::span<const std::byte, 3>(abc));
+    static_assert(keccak[0] == 0x4e && keccak[31] == 0x45);
+}
+
+TEST(TestSha, Scatter_Gather_Update) {
+    std::vector<std::byte> message(3000);
+    for (size_t i = 0; i < message.size(); ++i) message[i] = static_cast<std::byte>(i * 31 + 7);
+
+    // Fragments of every size up to a few blocks, so that words and blocks straddle the boundaries.
+    std::mt19937 random(2024);
+    std::vector<std::span<const std::byte>> fragments;
+    for (size_t offset = 0; offset < message.size();) {
+        const size_t size = std::min<size_t>(random() % 400, message.size() - offset);
+        fragments.push_back(std::span(message).subspan(offset, size));
+        offset += size;
+    }
+
+    const auto expected = keccak::SHA3Sponge<256>::hash_digest(message);
+    keccak::SHA3Sponge<256> sponge;
+    sponge.update(fragments);
+    EXPECT_EQ(sponge.digest(), expected);
+    EXPECT_EQ(keccak::SHA3Sponge<256>::hash_digest(fragments), expected);
+    EXPECT_EQ(keccak::SHA3_256::hash_digest(fragments), expected);
+    EXPECT_EQ(keccak::SHA3_256::hash_digest(fragments, 1), keccak::Keccak256::hash_digest(message));
+}
+
+template<typename SPONGE>
+void expect_small_fragments(const std::vector<std::byte> &message, size_t prefix) {
+    // Fragments of 1 to 7 bytes, so that almost every lane and every block straddles a boundary.
+    std::mt19937 random(static_cast<uint32_t>(prefix + SPONGE::RATE_BYTES));
+    std::vector<std::span<const std::byte>> fragments;
+    for (size_t offset = prefix; offset < message.size();) {
+        const size_t size = std::min<size_t>(random() % 7 + 1, message.size() - offset);
+        fragments.push_back(std::span(message).subspan(offset, size));
+        offset += size;
+    }
+
+    SPONGE sponge;
+    sponge.update(std::span(message).first(prefix));
+    sponge.update(fragments);
+    EXPECT_EQ(sponge.digest(), SPONGE::hash_digest(message)) << "prefix " << prefix;
+}
+
+TEST(TestSha, Scatter_Gather_Small_Fragments) {
+    std::vector<std::byte> message(1000);
+    for (size_t i = 0; i < message.size(); ++i) message[i] = static_cast<std::byte>(i * 29 + 3);
+
+    // A prefix leaving a partial word, a whole word, and part of a block in progress.
+    for (const size_t prefix: {0, 3, 8, 21, 140}) {
+        expect_small_fragments<keccak::SHA3Sponge<224>>(message, prefix);
+        expect_small_fragments<keccak::SHA3Sponge<256>>(message, prefix);
+        expect_small_fragments<keccak::SHA3Sponge<512>>(message, prefix);
+        expect_small_fragments<keccak::Keccak256>(message, prefix);
+    }
+
+    // The fragments hold fewer bytes than the pending partial word needs.
+    keccak::SHA3Sponge<256> sponge;
+    sponge.update(std::span(message).first(3));
+    const std::array<std::span<const std::byte>, 2> fragments = {std::span(message).subspan(3, 1),
+                                                                 std::span(message).subspan(4, 2)};
+    sponge.update(fragments);
+    sponge.update(std::span(message).subspan(6));
+    EXPECT_EQ(sponge.digest(), keccak::SHA3Sponge<256>::hash_digest(message));
+}
+
+TEST(TestSha, Serialize_Resume) {
+    std::vector<uint8_t> message(5000);
+    for (size_t i = 0; i < message.size(); ++i) message[i] = static_cast<uint8_t>(i * 13 + 5);
+
+    for (const uint8_t flag: {0, 1}) {
+        const auto expected = keccak::SHA3<256>::hash_digest(message.data(), message.size(), flag);
+        // Stop at a word boundary, in the middle of a word, and at the end of a block.
+        for (const size_t stop: {0, 3, 8, 135, 136, 1003, 4999}) {
+            keccak::SHA3<256> first(flag);
+            first.update(message.data(), stop);
+            const auto checkpoint = first.serialize();
+
+            auto resumed = keccak::SHA3<256>::deserialize(checkpoint);
+            ASSERT_TRUE(resumed.has_value()) << stop;
+            resumed->update(message.data() + stop, message.size() - stop);
+            EXPECT_EQ(resumed->digest(), expected) << stop;
+        }
+    }
+
+    keccak::Keccak256 sponge;
+    sponge.update(message.data(), 77);
+    auto checkpoint = sponge.serialize();
+    auto resumed = keccak::Keccak256::deserialize(checkpoint);
+    ASSERT_TRUE(resumed.has_value());
+    resumed->update(message.data() + 77, 100);
+    EXPECT_EQ(resumed->digest(), keccak::Keccak256::hash_digest(message.data(), 177));
+
+    // Contexts of other variants, versions or lengths are refused.
+    EXPECT_FALSE(keccak::SHA3Sponge<256>::deserialize(checkpoint).has_value());
+    EXPECT_FALSE(keccak::KeccakSponge<512>::deserialize(checkpoint).has_value());
+    EXPECT_FALSE(keccak::Keccak256::deserialize(std::span(checkpoint).first(100)).has_value());
+    auto corrupt = checkpoint;
+    corrupt[3] = std::byte{2};
+    EXPECT_FALSE(keccak::Keccak256::deserialize(corrupt).has_value());
+    corrupt = checkpoint;
+    corrupt[7] = std::byte{200};
+    EXPECT_FALSE(keccak::Keccak256::deserialize(corrupt).has_value());
+    corrupt = checkpoint;
+    corrupt[15] = std::byte{1};
+    EXPECT_FALSE(keccak::Keccak256::deserialize(corrupt).has_value());
+}
+
+namespace {
+
+// Selector and topic tables computed at build time.
+constexpr auto TRANSFER = keccak::literal_digest("transfer(address,uint256)");
+constexpr auto TRANSFER_EVENT = keccak::literal_digest("Transfer(address,address,uint256)");
+static_assert(TRANSFER[0] == 0xa9 && TRANSFER[1] == 0x05 && TRANSFER[2] == 0x9c && TRANSFER[3] == 0xbb);
+static_assert(TRANSFER_EVENT[0] == 0xdd && TRANSFER_EVENT[31] == 0xef);
+static_assert(keccak::literal_digest("")[0] == 0xc5 && keccak::literal_digest("")[31] == 0x70);
+
+constexpr auto sha3_512_bytes() {
+    constexpr std::array<std::byte, 3> abc = {std::byte{'a'}, std::byte{'b'}, std::byte{'c'}};
+    return keccak::SHA3_512::hash_digest(abc);
+}
+static_assert(sha3_512_bytes()[0] == 0xb7 && sha3_512_bytes()[63] == 0xf0);
+
+constexpr auto keccak_fragments() {
+    constexpr std::array<std::byte, 3> abc = {std::byte{'a'}, std::byte{'b'}, std::byte{'c'}};
+    const std::array<std::span<const std::byte>, 3> fragments = {
+            std::span(abc).first(1), std::span(abc).subspan(1, 0), std::span(abc).last(2)};
+    return keccak::Keccak256::hash_digest(fragments);
+}
+static_assert(keccak_fragments() == keccak::literal_digest("abc"));
+
+// A message long enough to take the bulk absorb path in constant evaluation.
+constexpr auto long_text() {
+    keccak::Keccak256 sponge;
+    for (int i = 0; i < 10; ++i) sponge.update("The quick brown fox jumps over the lazy dog");
+    return sponge.digest();
+}
+
+// The same message in fragments, so that its blocks are gathered across them in constant evaluation.
+constexpr auto long_fragments() {
+    constexpr std::string_view fox = "The quick brown fox jumps over the lazy dog";
+    std::array<std::byte, fox.size()> bytes{};
+    for (size_t i = 0; i < fox.size(); ++i) bytes[i] = static_cast<std::byte>(fox[i]);
+    std::array<std::span<const std::byte>, 10> fragments{};
+    fragments.fill(std::span<const std::byte>(bytes));
+    return keccak::Keccak256::hash_digest(fragments);
+}
+static_assert(long_fragments() == long_text());
+
+} // namespace
+
+TEST(TestSha, Constexpr_Digest) {
+    EXPECT_EQ(TRANSFER, keccak::Keccak256::hash_digest("transfer(address,uint256)", 25));
+    EXPECT_EQ(TRANSFER_EVENT, keccak::SHA3_256::hash_digest("Transfer(address,address,uint256)", 33, 1));
+
+    constexpr auto expected = long_text();
+    keccak::SHA3_256 sha3(1);
+    for (int i = 0; i < 10; ++i) sha3.update("The quick brown fox jumps over the lazy dog", 43);
+    EXPECT_EQ(sha3.digest(), expected);
+}
+
 TEST(TestSha, SHA3_256_Single_Buffer) {
     keccak::SHA3_256 sha3(0);
     uint8_t buf[200];
@@ -295,6 +545,125 @@ TEST(TestSha, SHA3_512_200_Steps) {
     EXPECT_EQ(std::memcmp(res.data(), SHA3_512_0xa3_200_TIMES, sizeof(SHA3_512_0xa3_200_TIMES)), 0);
 }
 
+template<size_t BIT>
+void expect_long_message(const uint8_t *expected) {
+    std::vector<uint8_t> message(100003);
+    for (size_t i = 0; i < message.size(); ++i) message[i] = static_cast<uint8_t>(i * 7 + 3);
+
+    keccak::SHA3<BIT> single(0);
+    single.update(message.data(), message.size());
+    auto res = single.finalize();
+    EXPECT_EQ(std::memcmp(res.data(), expected, BIT / 8), 0);
+
+    // Uneven chunks mix the byte, word and block paths of update.
+    keccak::SHA3<BIT> chunked(0);
+    size_t offset = 0;
+    for (size_t step = 0; offset < message.size(); ++step) {
+        const size_t length = std::min<size_t>((step * 37 + 1) % 1500, message.size() - offset);
+        chunked.update(message.data() + offset, length);
+        offset += length;
+    }
+    res = chunked.finalize();
+    EXPECT_EQ(std::memcmp(res.data(), expected, BIT / 8), 0);
+
+    auto digest = keccak::SHA3<BIT>::hash_digest(message.data(), message.size());
+    EXPECT_EQ(std::memcmp(digest.data(), expected, BIT / 8), 0);
+
+    std::array<std::byte, BIT / 8> out{};
+    keccak::SHA3<BIT> into(0);
+    into.update(message.data(), message.size());
+    into.finalize_into(out);
+    EXPECT_EQ(std::memcmp(out.data(), expected, BIT / 8), 0);
+}
+
+TEST(TestSha, SHA3_256_Long_Message) {
+    expect_long_message<256>(reinterpret_cast<const uint8_t *>(
+            "\x00\x78\x8f\x2c\x97\xec\xa2\xc4\xe7\xcd\xeb\x87\x75\x8a\x37\xbe"
+            "\xc1\xee\x8f\x06\x9e\x5b\x0f\xca\xcd\x07\x10\xa6\x63\xeb\x13\xbe"));
+}
+
+TEST(TestSha, SHA3_384_Long_Message) {
+    expect_long_message<384>(reinterpret_cast<const uint8_t *>(
+            "\xce\x3a\xbe\x36\x04\xfe\x61\x50\xf6\xe9\x7d\x45\x85\x70\x67\xbf"
+            "\x2f\xbf\xc8\x2c\xed\xce\x1f\xf1\x9c\x12\x6b\xff\x92\x13\xa3\x48"
+            "\x85\xf4\x20\xf2\x5e\x3f\x47\x41\x7c\xaa\x5f\x9f\xe0\xa9\xab\x7f"));
+}
+
+TEST(TestSha, SHA3_512_Long_Message) {
+    expect_long_message<512>(reinterpret_cast<const uint8_t *>(
+            "\x52\xc9\xd7\x2b\x93\x5b\xd8\x7a\x35\x9a\x6c\x9f\x03\x26\xa2\xed"
+            "\x4c\xab\x57\x29\x72\xed\x19\x4f\xc4\x3f\xcc\x0d\xe4\x77\x58\xdc"
+            "\x61\xc5\x4e\x88\xae\x2b\x26\xfb\x63\x2d\xa7\x7a\x3b\x69\x60\x6a"
+            "\x4e\xb0\x51\x25\xd8\x1d\xc0\x86\x51\x84\x9c\x31\x6f\x80\x43\x3c"));
+}
+
+template<size_t BIT>
+void expect_hash_many_matches_hash_buffer(int flag) {
+    std::mt19937 rng(0x5eed);
+    std::vector<std::vector<uint8_t>> messages(37);
+    for (auto &message: messages) {
+        message.resize(rng() % 600);
+        for (auto &byte: message) byte = static_cast<uint8_t>(rng());
+    }
+    std::vector<std::span<const uint8_t>> buffers(messages.begin(), messages.end());
+    std::vector<std::array<uint8_t, BIT / 8>> digests(messages.size());
+
+    keccak::SHA3<BIT>::hash_many(buffers, digests, flag);
+    for (size_t i = 0; i < messages.size(); ++i) {
+        auto res = keccak::SHA3<BIT>::hash_buffer(messages[i].data(), messages[i].size(), flag);
+        EXPECT_EQ(std::memcmp(res.data(), digests[i].data(), BIT / 8), 0) << "message " << i;
+    }
+}
+
+TEST(TestSha, Hash_Many) {
+    expect_hash_many_matches_hash_buffer<256>(0);
+    expect_hash_many_matches_hash_buffer<256>(1);
+    expect_hash_many_matches_hash_buffer<384>(0);
+    expect_hash_many_matches_hash_buffer<512>(0);
+    expect_hash_many_matches_hash_buffer<512>(1);
+}
+
+TEST(TestSha, Runtime_Flag_Hides_NIST_Sponge) {
+    // A Keccak hasher must not be finalized through the NIST padding of its sponge.
+    static_assert(!std::is_convertible_v<keccak::SHA3<256> *, keccak::SHA3Sponge<256> *>);
+    static_assert(!std::is_convertible_v<keccak::SHA3_256 &, keccak::SHA3Sponge<256> &>);
+
+    keccak::SHA3_256 sha3(1);
+    sha3.update("abc", 3);
+    EXPECT_EQ(sha3.digest(), keccak::Keccak256::hash_digest("abc", 3));
+}
+
+template<size_t BIT, size_t N>
+void expect_sha3_fixed(const uint8_t *message) {
+    for (const int flag: {0, 1}) {
+        EXPECT_EQ(keccak::SHA3<BIT>::template hash_fixed<N>(message, flag),
+                  keccak::SHA3<BIT>::hash_digest(message, N, flag)) << "length " << N << ", flag " << flag;
+    }
+}
+
+TEST(TestSha, SHA3_Hash_Fixed_Flag) {
+    std::array<uint8_t, 100> message{};
+    for (size_t i = 0; i < message.size(); ++i) message[i] = static_cast<uint8_t>(i * 5 + 2);
+    expect_sha3_fixed<256, 0>(message.data());
+    expect_sha3_fixed<256, 3>(message.data());
+    expect_sha3_fixed<256, 32>(message.data());
+    expect_sha3_fixed<224, 64>(message.data());
+    expect_sha3_fixed<512, 71>(message.data());
+    EXPECT_EQ(keccak::SHA3_256::hash_fixed<3>("abc", 1), keccak::Keccak256::hash_digest("abc", 3));
+
+    constexpr std::array<std::byte, 3> abc = {std::byte{'a'}, std::byte{'b'}, std::byte{'c'}};
+    static_assert(keccak::SHA3<256>::hash_fixed(std::span<const std::byte, 3>(abc), 1)[0] == 0x4e);
+}
+
+TEST(TestSha, Hash_Many_Size_Mismatch) {
+    std::vector<uint8_t> message(100, 0xa5);
+    std::vector<std::span<const uint8_t>> buffers(3, message);
+    std::vector<std::array<uint8_t, 32>> digests(2);
+
+    EXPECT_THROW(keccak::SHA3<256>::hash_many(buffers, digests), std::invalid_argument);
+    EXPECT_THROW(keccak::SHA3<256>::hash_many(buffers, digests, 1), std::invalid_argument);
+}
+
 TEST(TestSha, Keccak_F_1600) {
     constexpr std::array<uint64_t, keccak::core::P_LEN> state_first = {
             0xF1258F7940E1DDE7, 0x84D5CCF933C0478A, 0xD598261EA65AA9EE, 0xBD1547306F80494D, 0x8B284E056253D057,
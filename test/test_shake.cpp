@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include "sha3_256.h"
+#include "shake.h"
+
+namespace {
+
+auto message_1000() -> std::vector<uint8_t> {
+    std::vector<uint8_t> message(1000);
+    for (size_t i = 0; i < message.size(); ++i) message[i] = static_cast<uint8_t>(i * 7 + 3);
+    return message;
+}
+
+/// Squeeze 1000 bytes in uneven pieces and return the SHA3-256 of the whole output.
+template<size_t BIT>
+auto squeeze_1000_digest() -> std::array<uint64_t, keccak::SHA3_256::SPONGE_WORDS> {
+    auto message = message_1000();
+    keccak::SHAKE<BIT> shake;
+    shake.update(message.data(), 10);
+    shake.update(message.data() + 10, message.size() - 10);
+
+    std::vector<uint8_t> out(1000);
+    size_t offset = 0;
+    for (size_t step = 1; offset < out.size(); ++step) {
+        const size_t length = std::min(step * step, out.size() - offset);
+        shake.squeeze(out.data() + offset, length);
+        offset += length;
+    }
+    return keccak::SHA3_256::hash_buffer(out.data(), out.size(), 0);
+}
+
+} // namespace
+
+TEST(TestShake, SHAKE128_Empty) {
+    uint8_t out[32];
+    keccak::SHAKE128::hash_buffer("", 0, out, sizeof(out));
+    EXPECT_EQ(std::memcmp(out,
+                          "\x7f\x9c\x2b\xa4\xe8\x8f\x82\x7d\x61\x60\x45\x50\x76\x05\x85\x3e"
+                          "\xd7\x3b\x80\x93\xf6\xef\xbc\x88\xeb\x1a\x6e\xac\xfa\x66\xef\x26", 32), 0);
+}
+
+TEST(TestShake, SHAKE256_Empty) {
+    uint8_t out[64];
+    keccak::SHAKE256::hash_buffer("", 0, out, sizeof(out));
+    EXPECT_EQ(std::memcmp(out,
+                          "\x46\xb9\xdd\x2b\x0b\xa8\x8d\x13\x23\x3b\x3f\xeb\x74\x3e\xeb\x24"
+                          "\x3f\xcd\x52\xea\x62\xb8\x1b\x82\xb5\x0c\x27\x64\x6e\xd5\x76\x2f"
+                          "\xd7\x5d\xc4\xdd\xd8\xc0\xf2\x00\xcb\x05\x01\x9d\x67\xb5\x92\xf6"
+                          "\xfc\x82\x1c\x49\x47\x9a\xb4\x86\x40\x29\x2e\xac\xb3\xb7\xc4\xbe", 64), 0);
+}
+
+TEST(TestShake, SHAKE128_Incremental_Squeeze) {
+    auto res = squeeze_1000_digest<128>();
+    EXPECT_EQ(std::memcmp(res.data(),
+                          "\xc6\x4b\x23\x78\xdf\xda\x89\x51\xc9\xb8\xcc\x8c\xca\x15\x93\x39"
+                          "\x85\x77\x1b\x00\xbb\xce\x8c\x25\xde\xb5\xb0\xbf\xfc\x43\x5e\x9c", 32), 0);
+}
+
+TEST(TestShake, SHAKE256_Incremental_Squeeze) {
+    auto res = squeeze_1000_digest<256>();
+    EXPECT_EQ(std::memcmp(res.data(),
+                          "\xb1\xf8\x1f\x47\x23\x00\x6d\x35\x87\xc5\x4f\xae\x6a\x85\x7d\xdd"
+                          "\xb4\x83\x2c\x35\x7e\xfd\xf4\xac\x63\x9b\xbe\xd7\xcc\x6a\x45\x6d", 32), 0);
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "sha3.h"
+#include "sponge_pool.h"
+
+TEST(TestSpongePool, Flush_Matches_One_Shot) {
+    std::vector<std::byte> message(20000);
+    for (size_t i = 0; i < message.size(); ++i) message[i] = static_cast<std::byte>(i * 11 + 1);
+
+    // More contexts than lanes, with messages of many lengths cut into pieces of many sizes.
+    keccak::SpongePool<keccak::SHA3Sponge<256>> pool;
+    std::mt19937 random(7);
+    std::vector<keccak::SpongePool<keccak::SHA3Sponge<256>>::Handle> handles;
+    std::vector<size_t> lengths, offsets;
+    for (size_t i = 0; i < 37; ++i) {
+        handles.push_back(pool.acquire());
+        lengths.push_back(random() % message.size());
+        offsets.push_back(0);
+    }
+    EXPECT_EQ(pool.size(), 37);
+
+    for (int round = 0; round < 6; ++round) {
+        for (size_t i = 0; i < handles.size(); ++i) {
+            // Two pieces per context and flush, so that queued absorbs of one context keep their order.
+            for (int piece = 0; piece < 2; ++piece) {
+                const size_t n = std::min<size_t>(random() % 3000, lengths[i] - offsets[i]);
+                pool.enqueue(handles[i], std::span(message).subspan(offsets[i], n));
+                offsets[i] += n;
+            }
+        }
+        pool.flush();
+    }
+    for (size_t i = 0; i < handles.size(); ++i) {
+        pool.update(handles[i], message.data() + offsets[i], lengths[i] - offsets[i]);
+        EXPECT_EQ(pool.digest(handles[i]), keccak::SHA3Sponge<256>::hash_digest(message.data(), lengths[i])) << i;
+    }
+}
+
+TEST(TestSpongePool, Recycles_Contexts) {
+    keccak::SpongePool<keccak::SHA3<512>> pool;
+    const auto keccak = pool.acquire(1);
+    pool.update(keccak, "abc", 3);
+    EXPECT_EQ(pool.digest(keccak), keccak::KeccakSponge<512>::hash_digest("abc", 3));
+
+    pool.reset(keccak);
+    pool.update(keccak, "abcd", 4);
+    EXPECT_EQ(pool.digest(keccak), keccak::KeccakSponge<512>::hash_digest("abcd", 4));
+
+    pool.release(keccak);
+    EXPECT_EQ(pool.size(), 0);
+    const auto sha3 = pool.acquire();
+    EXPECT_EQ(sha3.index, keccak.index);
+    EXPECT_NE(sha3.generation, keccak.generation);
+    pool.update(sha3, "abc", 3);
+    EXPECT_EQ(pool[sha3].serialize(), [] {
+        keccak::SHA3<512> expected;
+        expected.update("abc", 3);
+        return expected.serialize();
+    }());
+    EXPECT_EQ(pool.digest(sha3), keccak::SHA3Sponge<512>::hash_digest("abc", 3));
+
+    static_assert(sizeof(keccak::SHA3<512>) <= 256);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(&pool[sha3]) % 64, 0);
+}
@@ -0,0 +1,100 @@
+#include "digest.h"
+
+#include "sha3.h"
+#include "shake.h"
+
+namespace keccaksum {
+namespace {
+
+template<size_t BIT>
+class SHA3Hasher : public Hasher {
+    keccak::SHA3<BIT> sha3;
+
+public:
+    explicit SHA3Hasher(bool keccak) : sha3(keccak ? 1 : 0) {}
+
+    void update(const uint8_t *data, size_t length) override {
+        this->sha3.update(data, length);
+    }
+
+    auto finish() -> std::vector<uint8_t> override {
+        const auto digest = this->sha3.digest();
+        return {digest.begin(), digest.end()};
+    }
+};
+
+template<size_t BIT>
+class SHAKEHasher : public Hasher {
+    keccak::SHAKE<BIT> shake;
+    size_t out_length;
+
+public:
+    explicit SHAKEHasher(size_t out_length) : shake(), out_length{out_length} {}
+
+    void update(const uint8_t *data, size_t length) override {
+        this->shake.update(data, length);
+    }
+
+    auto finish() -> std::vector<uint8_t> override {
+        std::vector<uint8_t> digest(this->out_length);
+        this->shake.squeeze(digest.data(), digest.size());
+        return digest;
+    }
+};
+
+} // namespace
+
+auto Algorithm::from_number(unsigned number, bool keccak, size_t out_bits) -> std::optional<Algorithm> {
+    switch (number) {
+        case 224:
+        case 256:
+        case 384:
+        case 512:
+            if (out_bits != 0) return std::nullopt;
+            return Algorithm{number, keccak, number / 8};
+        case 128000:
+        case 256000: {
+            // sha3sum squeezes one rate-sized block by default.
+            if (keccak || out_bits % 8 != 0) return std::nullopt;
+            const size_t rate = number == 128000 ? keccak::SHAKE128::RATE : keccak::SHAKE256::RATE;
+            return Algorithm{number, false, out_bits != 0 ? out_bits / 8 : rate};
+        }
+        default:
+            return std::nullopt;
+    }
+}
+
+auto Algorithm::name() const -> std::string {
+    if (this->number >= 128000) return "SHAKE" + std::to_string(this->number / 1000);
+    return (this->keccak ? "Keccak-" : "SHA3-") + std::to_string(this->number);
+}
+
+auto Hasher::create(const Algorithm &algorithm) -> std::unique_ptr<Hasher> {
+    switch (algorithm.number) {
+        case 224:
+            return std::make_unique<SHA3Hasher<224>>(algorithm.keccak);
+        case 256:
+            return std::make_unique<SHA3Hasher<256>>(algorithm.keccak);
+        case 384:
+            return std::make_unique<SHA3Hasher<384>>(algorithm.keccak);
+        case 512:
+            return std::make_unique<SHA3Hasher<512>>(algorithm.keccak);
+        case 128000:
+            return std::make_unique<SHAKEHasher<128>>(algorithm.out_length);
+        default:
+            return std::make_unique<SHAKEHasher<256>>(algorithm.out_length);
+    }
+}
+
+auto to_hex(const std::vector<uint8_t> &digest) -> std::string {
+    constexpr char DIGITS[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(2 * digest.size());
+    for (const uint8_t byte: digest) {
+        hex += DIGITS[byte >> 4];
+        hex += DIGITS[byte & 0xf];
+    }
+    return hex;
+}
+
+} // namespace keccaksum
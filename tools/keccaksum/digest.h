@@ -0,0 +1,78 @@
+#ifndef KECCAK_KECCAKSUM_DIGEST_H
+#define KECCAK_KECCAKSUM_DIGEST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace keccaksum {
+
+/**
+ * @brief A hash function picked on the command line.
+ */
+struct Algorithm {
+    /// The sha3sum algorithm number: 224, 256, 384, 512, or 128000 and 256000 for SHAKE.
+    unsigned number;
+    /// Whether to use the Keccak padding instead of NIST-SHA3.
+    bool keccak;
+    /// The output length in bytes.
+    size_t out_length;
+
+    /**
+     * @brief Look up an algorithm by its sha3sum number.
+     * @param number The algorithm number.
+     * @param keccak Whether to use the Keccak padding, only for the fixed-length hashes.
+     * @param out_bits The SHAKE output length in bits, 0 for the sha3sum default.
+     * @return The algorithm, or nothing if the combination is not supported.
+     */
+    static auto from_number(unsigned number, bool keccak, size_t out_bits) -> std::optional<Algorithm>;
+
+    /**
+     * @brief The name of the algorithm, as used by `--tag` lines.
+     * @return The name.
+     */
+    [[nodiscard]] auto name() const -> std::string;
+};
+
+/**
+ * @brief A running hash of one input.
+ */
+class Hasher {
+public:
+    virtual ~Hasher() = default;
+
+    /**
+     * @brief Absorb the next bytes of the input.
+     * @param data The bytes.
+     * @param length The number of bytes.
+     */
+    virtual void update(const uint8_t *data, size_t length) = 0;
+
+    /**
+     * @brief Finish the input and produce the hash.
+     * @return The hash.
+     */
+    virtual auto finish() -> std::vector<uint8_t> = 0;
+
+    /**
+     * @brief Start a hash.
+     * @param algorithm The algorithm.
+     * @return The hasher.
+     */
+    static auto create(const Algorithm &algorithm) -> std::unique_ptr<Hasher>;
+};
+
+/**
+ * @brief Format a hash as lowercase hex.
+ * @param digest The hash.
+ * @return The hex string.
+ */
+auto to_hex(const std::vector<uint8_t> &digest) -> std::string;
+
+} // namespace keccaksum
+
+#endif //KECCAK_KECCAKSUM_DIGEST_H
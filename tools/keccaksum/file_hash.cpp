@@ -0,0 +1,128 @@
+#include "file_hash.h"
+
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace keccaksum {
+namespace {
+
+/**
+ * @brief Read until the buffer is full or the input ends.
+ * @return The number of bytes read, or -1 with errno set.
+ */
+auto read_full(int fd, uint8_t *buffer, size_t size) -> ssize_t {
+    size_t total = 0;
+    while (total < size) {
+        const ssize_t n = ::read(fd, buffer + total, size - total);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) return -1;
+        if (n == 0) break;
+        total += static_cast<size_t>(n);
+    }
+    return static_cast<ssize_t>(total);
+}
+
+/**
+ * @brief Hash the input through two buffers: one reader thread fills each in turn while the other is hashed.
+ * @return The errno of a failed read, 0 on success.
+ */
+auto hash_stream(int fd, Hasher &hasher) -> int {
+    std::vector<uint8_t> buffers[2] = {std::vector<uint8_t>(READ_BYTES), std::vector<uint8_t>(READ_BYTES)};
+    // The length read into each buffer, or the negated errno, valid while the buffer is filled.
+    ssize_t lengths[2] = {0, 0};
+    bool filled[2] = {false, false};
+
+    lengths[0] = read_full(fd, buffers[0].data(), READ_BYTES);
+    // Inputs shorter than one buffer are done after the first read, without starting the reader.
+    if (lengths[0] != static_cast<ssize_t>(READ_BYTES)) {
+        if (lengths[0] < 0) return errno;
+        hasher.update(buffers[0].data(), static_cast<size_t>(lengths[0]));
+        return 0;
+    }
+    filled[0] = true;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    // Both sides stop after the first short or failed read.
+    std::thread reader([&] {
+        for (size_t current = 1;; current ^= 1) {
+            {
+                std::unique_lock lock(mutex);
+                changed.wait(lock, [&] { return !filled[current]; });
+            }
+            const ssize_t n = read_full(fd, buffers[current].data(), READ_BYTES);
+            const ssize_t length = n < 0 ? -static_cast<ssize_t>(errno) : n;
+            {
+                std::lock_guard lock(mutex);
+                lengths[current] = length;
+                filled[current] = true;
+            }
+            changed.notify_one();
+            if (length != static_cast<ssize_t>(READ_BYTES)) return;
+        }
+    });
+
+    int error = 0;
+    for (size_t current = 0;; current ^= 1) {
+        ssize_t length;
+        {
+            std::unique_lock lock(mutex);
+            changed.wait(lock, [&] { return filled[current]; });
+            length = lengths[current];
+        }
+        if (length < 0) {
+            error = static_cast<int>(-length);
+            break;
+        }
+        hasher.update(buffers[current].data(), static_cast<size_t>(length));
+        {
+            std::lock_guard lock(mutex);
+            filled[current] = false;
+        }
+        changed.notify_one();
+        if (length != static_cast<ssize_t>(READ_BYTES)) break;
+    }
+    reader.join();
+    return error;
+}
+
+/**
+ * @brief Hash a regular file through a read-only mapping with sequential read-ahead.
+ * @return Whether the file could be mapped; if not, nothing has been hashed.
+ */
+auto hash_mapped(int fd, size_t size, Hasher &hasher) -> bool {
+    void *map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) return false;
+    ::madvise(map, size, MADV_SEQUENTIAL);
+    hasher.update(static_cast<const uint8_t *>(map), size);
+    ::munmap(map, size);
+    return true;
+}
+
+} // namespace
+
+auto hash_file(const std::string &path, const Algorithm &algorithm) -> FileHash {
+    const bool standard_input = path == "-";
+    const int fd = standard_input ? STDIN_FILENO : ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return {{}, std::strerror(errno)};
+
+    auto hasher = Hasher::create(algorithm);
+    struct stat info{};
+    const bool mapped = ::fstat(fd, &info) == 0 && S_ISREG(info.st_mode)
+                        && static_cast<size_t>(info.st_size) >= MMAP_MIN_BYTES
+                        && hash_mapped(fd, static_cast<size_t>(info.st_size), *hasher);
+    const int error = mapped ? 0 : hash_stream(fd, *hasher);
+    if (!standard_input) ::close(fd);
+
+    if (error != 0) return {{}, std::strerror(error)};
+    return {hasher->finish(), {}};
+}
+
+} // namespace keccaksum
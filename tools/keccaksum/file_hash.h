@@ -0,0 +1,39 @@
+#ifndef KECCAK_KECCAKSUM_FILE_HASH_H
+#define KECCAK_KECCAKSUM_FILE_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "digest.h"
+
+namespace keccaksum {
+
+/// Regular files at least this large are memory-mapped instead of read.
+constexpr size_t MMAP_MIN_BYTES = 1 << 20;
+/// The size of each of the two read buffers.
+constexpr size_t READ_BYTES = 256 << 10;
+
+/**
+ * @brief The hash of one file, or why it could not be read.
+ */
+struct FileHash {
+    /// The hash, empty on error.
+    std::vector<uint8_t> digest;
+    /// The error message, empty on success.
+    std::string error;
+};
+
+/**
+ * @brief Hash a file: large regular files through a sequential memory mapping, anything else through
+ * double-buffered reads that overlap the next read with hashing.
+ * @param path The path, or "-" for the standard input.
+ * @param algorithm The algorithm.
+ * @return The hash or the error.
+ */
+auto hash_file(const std::string &path, const Algorithm &algorithm) -> FileHash;
+
+} // namespace keccaksum
+
+#endif //KECCAK_KECCAKSUM_FILE_HASH_H
@@ -0,0 +1,352 @@
+#include <cctype>
+#include <charconv>
+#include <cstdlib>
+#include <fstream>
+#include <future>
+#include <getopt.h>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "digest.h"
+#include "file_hash.h"
+#include "thread_pool.h"
+
+namespace keccaksum {
+namespace {
+
+constexpr char USAGE[] =
+        "Usage: keccaksum [OPTION]... [FILE]...\n"
+        "Print or check SHA3, Keccak and SHAKE checksums; with no FILE, or when FILE is -, read standard input.\n"
+        "\n"
+        "  -a, --algorithm N   224, 256 (default), 384, 512, 128000 (SHAKE128) or 256000 (SHAKE256)\n"
+        "  -k, --keccak        use the original Keccak padding instead of NIST-SHA3\n"
+        "  -l, --length BITS   SHAKE output length in bits (default: one rate-sized block)\n"
+        "  -b, --binary        read in binary mode, marking names with '*'\n"
+        "  -t, --text          read in text mode (default; files are hashed as is)\n"
+        "      --tag           print BSD-style checksums\n"
+        "  -j, --jobs N        hash N files at once (default: one per hardware thread)\n"
+        "  -c, --check         read checksums from the FILEs and check them\n"
+        "\n"
+        "The following options are useful only when verifying checksums:\n"
+        "  -q, --quiet         don't print OK for each successfully verified file\n"
+        "  -s, --status        don't output anything, status code shows success\n"
+        "  -w, --warn          warn about improperly formatted checksum lines\n"
+        "  -h, --help          display this help and exit\n";
+
+struct Options {
+    unsigned number = 256;
+    bool number_given = false;
+    bool keccak = false;
+    size_t out_bits = 0;
+    bool binary = false;
+    bool tag = false;
+    size_t jobs = 0;
+    bool check = false;
+    bool quiet = false;
+    bool status = false;
+    bool warn = false;
+    std::vector<std::string> files;
+};
+
+/**
+ * @brief One line of a checksum file.
+ */
+struct Entry {
+    std::string name;
+    std::string hex;
+    Algorithm algorithm;
+};
+
+/**
+ * @brief Format a file name the way sha3sum does: names with a backslash or a newline are escaped, and the line
+ * then starts with a backslash.
+ * @return The escaped name, and whether it needed escaping.
+ */
+auto escape(const std::string &name) -> std::pair<std::string, bool> {
+    if (name.find_first_of("\\\n") == std::string::npos) return {name, false};
+    std::string escaped;
+    for (const char c: name) {
+        if (c == '\\') escaped += "\\\\";
+        else if (c == '\n') escaped += "\\n";
+        else escaped += c;
+    }
+    return {escaped, true};
+}
+
+auto unescape(const std::string &name) -> std::string {
+    std::string plain;
+    for (size_t i = 0; i < name.size(); ++i) {
+        if (name[i] == '\\' && i + 1 < name.size()) {
+            plain += name[++i] == 'n' ? '\n' : name[i];
+        } else {
+            plain += name[i];
+        }
+    }
+    return plain;
+}
+
+auto is_hex(const std::string &hex) -> bool {
+    return !hex.empty() && hex.size() % 2 == 0
+           && hex.find_first_not_of("0123456789abcdefABCDEF") == std::string::npos;
+}
+
+/**
+ * @brief Parse the bit length of an algorithm tag, e.g. the `256` of `SHA3-256`.
+ * @param digits The decimal digits, nothing else.
+ * @param limit The largest length accepted.
+ * @return The length, or nothing if the digits are malformed or above the limit.
+ */
+auto parse_number(std::string_view digits, unsigned limit) -> std::optional<unsigned> {
+    unsigned number = 0;
+    const auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), number);
+    if (digits.empty() || error != std::errc{} || end != digits.data() + digits.size() || number > limit) {
+        return std::nullopt;
+    }
+    return number;
+}
+
+/**
+ * @brief Parse one checksum line, either `HEX  NAME`, `HEX *NAME` or `ALGORITHM (NAME) = HEX`.
+ * @return The entry, or nothing if the line is improperly formatted.
+ */
+auto parse_line(std::string line, const Options &options) -> std::optional<Entry> {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    const bool escaped = !line.empty() && line.front() == '\\';
+    if (escaped) line.erase(0, 1);
+
+    std::string name, hex;
+    std::optional<Algorithm> algorithm;
+
+    const size_t open = line.find(" (");
+    const size_t close = line.rfind(") = ");
+    if (open != std::string::npos && close != std::string::npos && close > open) {
+        // The BSD-style line names its algorithm.
+        const std::string tag = line.substr(0, open);
+        name = line.substr(open + 2, close - open - 2);
+        hex = line.substr(close + 4);
+        if (!is_hex(hex)) return std::nullopt;
+        const bool keccak = tag.rfind("Keccak-", 0) == 0;
+        if (tag.rfind("SHAKE", 0) == 0) {
+            const auto number = parse_number(std::string_view(tag).substr(5), 256);
+            if (!number) return std::nullopt;
+            algorithm = Algorithm::from_number(*number * 1000, false, hex.size() * 4);
+        } else if (keccak || tag.rfind("SHA3-", 0) == 0) {
+            const auto number = parse_number(std::string_view(tag).substr(keccak ? 7 : 5), 512);
+            if (!number) return std::nullopt;
+            algorithm = Algorithm::from_number(*number, keccak, 0);
+        }
+    } else {
+        const size_t space = line.find(' ');
+        if (space == std::string::npos || space + 2 > line.size()) return std::nullopt;
+        if (line[space + 1] != ' ' && line[space + 1] != '*') return std::nullopt;
+        hex = line.substr(0, space);
+        name = line.substr(space + 2);
+        if (!is_hex(hex)) return std::nullopt;
+        if (options.number_given) {
+            const bool shake = options.number >= 128000;
+            algorithm = Algorithm::from_number(options.number, options.keccak, shake ? hex.size() * 4 : 0);
+        } else {
+            // Without -a the fixed-length hash is told apart by its length.
+            algorithm = Algorithm::from_number(static_cast<unsigned>(hex.size() * 4), options.keccak, 0);
+        }
+    }
+
+    if (!algorithm || algorithm->out_length * 2 != hex.size()) return std::nullopt;
+    for (char &c: hex) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return Entry{escaped ? unescape(name) : name, hex, *algorithm};
+}
+
+auto compute(const Options &options, const Algorithm &algorithm, keccak::ThreadPool &pool) -> int {
+    std::vector<std::future<FileHash>> pending;
+    for (const auto &file: options.files) {
+        pending.push_back(pool.submit([&file, &algorithm] { return hash_file(file, algorithm); }));
+    }
+
+    int status = EXIT_SUCCESS;
+    for (size_t i = 0; i < pending.size(); ++i) {
+        const FileHash result = pending[i].get();
+        if (!result.error.empty()) {
+            std::cerr << "keccaksum: " << options.files[i] << ": " << result.error << "\n";
+            status = EXIT_FAILURE;
+            continue;
+        }
+        const auto [name, escaped] = escape(options.files[i]);
+        if (options.tag) {
+            std::cout << (escaped ? "\\" : "") << algorithm.name() << " (" << name << ") = " << to_hex(result.digest)
+                      << "\n";
+        } else {
+            std::cout << (escaped ? "\\" : "") << to_hex(result.digest) << (options.binary ? " *" : "  ") << name
+                      << "\n";
+        }
+    }
+    return status;
+}
+
+auto check(const Options &options, keccak::ThreadPool &pool) -> int {
+    int status = EXIT_SUCCESS;
+    for (const auto &file: options.files) {
+        std::ifstream stream;
+        if (file != "-") {
+            stream.open(file);
+            if (!stream) {
+                std::cerr << "keccaksum: " << file << ": No such file or directory\n";
+                status = EXIT_FAILURE;
+                continue;
+            }
+        }
+        std::istream &input = file == "-" ? std::cin : stream;
+
+        std::vector<Entry> entries;
+        size_t improper = 0;
+        std::string line;
+        for (size_t number = 1; std::getline(input, line); ++number) {
+            if (auto entry = parse_line(line, options)) {
+                entries.push_back(std::move(*entry));
+                continue;
+            }
+            ++improper;
+            if (options.warn) {
+                std::cerr << "keccaksum: " << file << ": " << number << ": improperly formatted SHA3 checksum line\n";
+            }
+        }
+        if (entries.empty()) {
+            std::cerr << "keccaksum: " << file << ": no properly formatted SHA3 checksum lines found\n";
+            status = EXIT_FAILURE;
+            continue;
+        }
+
+        std::vector<std::future<FileHash>> pending;
+        for (const auto &entry: entries) {
+            pending.push_back(pool.submit([&entry] { return hash_file(entry.name, entry.algorithm); }));
+        }
+
+        size_t unreadable = 0, mismatched = 0;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            const FileHash result = pending[i].get();
+            const char *verdict = "OK";
+            if (!result.error.empty()) {
+                if (!options.status) std::cerr << "keccaksum: " << entries[i].name << ": " << result.error << "\n";
+                verdict = "FAILED open or read";
+                ++unreadable;
+            } else if (to_hex(result.digest) != entries[i].hex) {
+                verdict = "FAILED";
+                ++mismatched;
+            } else if (options.quiet) {
+                continue;
+            }
+            if (!options.status) std::cout << entries[i].name << ": " << verdict << "\n";
+        }
+
+        if (!options.status) {
+            if (improper > 0 && options.warn) {
+                std::cerr << "keccaksum: WARNING: " << improper << " line" << (improper > 1 ? "s are" : " is")
+                          << " improperly formatted\n";
+            }
+            if (unreadable > 0) {
+                std::cerr << "keccaksum: WARNING: " << unreadable << " listed file" << (unreadable > 1 ? "s" : "")
+                          << " could not be read\n";
+            }
+            if (mismatched > 0) {
+                std::cerr << "keccaksum: WARNING: " << mismatched << " computed checksum" << (mismatched > 1 ? "s" : "")
+                          << " did NOT match\n";
+            }
+        }
+        if (unreadable > 0 || mismatched > 0) status = EXIT_FAILURE;
+    }
+    return status;
+}
+
+auto parse(int argc, char **argv, Options &options) -> bool {
+    enum { TAG = 256 };
+    const option long_options[] = {
+            {"algorithm", required_argument, nullptr, 'a'},
+            {"keccak",    no_argument,       nullptr, 'k'},
+            {"length",    required_argument, nullptr, 'l'},
+            {"binary",    no_argument,       nullptr, 'b'},
+            {"text",      no_argument,       nullptr, 't'},
+            {"tag",       no_argument,       nullptr, TAG},
+            {"jobs",      required_argument, nullptr, 'j'},
+            {"check",     no_argument,       nullptr, 'c'},
+            {"quiet",     no_argument,       nullptr, 'q'},
+            {"status",    no_argument,       nullptr, 's'},
+            {"warn",      no_argument,       nullptr, 'w'},
+            {"help",      no_argument,       nullptr, 'h'},
+            {nullptr, 0,                     nullptr, 0},
+    };
+
+    int c;
+    while ((c = getopt_long(argc, argv, "a:kl:btj:cqswh", long_options, nullptr)) != -1) {
+        switch (c) {
+            case 'a':
+                options.number = static_cast<unsigned>(std::strtoul(optarg, nullptr, 10));
+                options.number_given = true;
+                break;
+            case 'k':
+                options.keccak = true;
+                break;
+            case 'l':
+                options.out_bits = std::strtoul(optarg, nullptr, 10);
+                break;
+            case 'b':
+                options.binary = true;
+                break;
+            case 't':
+                options.binary = false;
+                break;
+            case TAG:
+                options.tag = true;
+                break;
+            case 'j':
+                options.jobs = std::strtoul(optarg, nullptr, 10);
+                break;
+            case 'c':
+                options.check = true;
+                break;
+            case 'q':
+                options.quiet = true;
+                break;
+            case 's':
+                options.status = true;
+                break;
+            case 'w':
+                options.warn = true;
+                break;
+            case 'h':
+                std::cout << USAGE;
+                std::exit(EXIT_SUCCESS);
+            default:
+                return false;
+        }
+    }
+    for (int i = optind; i < argc; ++i) options.files.emplace_back(argv[i]);
+    if (options.files.empty()) options.files.emplace_back("-");
+    return true;
+}
+
+} // namespace
+} // namespace keccaksum
+
+int main(int argc, char **argv) {
+    using namespace keccaksum;
+
+    std::ios::sync_with_stdio(false);
+    Options options;
+    if (!parse(argc, argv, options)) {
+        std::cerr << "Try 'keccaksum --help' for more information.\n";
+        return EXIT_FAILURE;
+    }
+
+    keccak::ThreadPool pool(options.jobs);
+    if (options.check) return check(options, pool);
+
+    const auto algorithm = Algorithm::from_number(options.number, options.keccak, options.out_bits);
+    if (!algorithm) {
+        std::cerr << "keccaksum: unsupported algorithm or output length\n";
+        return EXIT_FAILURE;
+    }
+    return compute(options, *algorithm, pool);
+}